@@ -58,6 +58,7 @@ BufferCacheEntry::~BufferCacheEntry() {
 
 void BufferCacheEntry::clear() {
   if (mHandle) {
+    sdm::HWCBufferFdRegistry::GetInstance()->Evict(mHandle);
     mHandleImporter.freeBuffer(mHandle);
   }
 }
@@ -1310,6 +1311,13 @@ Error QtiComposerClient::CommandReader::parse() {
       break;
     }
 
+    // Only display selection and further validates may be batched behind deferred validates.
+    if (!mPendingValidates.empty() &&
+        qticommand != IQtiComposerClient::Command::SELECT_DISPLAY &&
+        qticommand != IQtiComposerClient::Command::VALIDATE_DISPLAY) {
+      flushPendingValidates();
+    }
+
     bool parsed = false;
     switch (qticommand) {
       case IQtiComposerClient::Command::SET_LAYER_TYPE:
@@ -1338,6 +1346,8 @@ Error QtiComposerClient::CommandReader::parse() {
     }
   }
 
+  flushPendingValidates();
+
   return (isEmpty()) ? Error::NONE : Error::BAD_PARAMETER;
 }
 
@@ -1488,10 +1498,9 @@ bool QtiComposerClient::CommandReader::parseValidateDisplay(uint16_t length) {
     return false;
   }
 
-  std::vector<Layer> changedLayers;
-  std::vector<IComposerClient::Composition> compositionTypes;
-  std::vector<Layer> requestedLayers;
-  std::vector<uint32_t> requestMasks;
+  if (deferValidateDisplay()) {
+    return true;
+  }
 
   auto err = validateDisplay();
 
@@ -1502,6 +1511,56 @@ bool QtiComposerClient::CommandReader::parseValidateDisplay(uint16_t length) {
   return true;
 }
 
+bool QtiComposerClient::CommandReader::deferValidateDisplay() {
+  if (!mClient.hwc_session_->IsParallelValidateEnabled()) {
+    return false;
+  }
+
+  for (auto &pending : mPendingValidates) {
+    if (pending.display == mDisplay) {
+      // Second validate of the same display needs the result of the first one.
+      flushPendingValidates();
+      break;
+    }
+  }
+
+  mPendingValidates.push_back({mDisplay, getCommandLoc()});
+  return true;
+}
+
+void QtiComposerClient::CommandReader::flushPendingValidates() {
+  if (mPendingValidates.empty()) {
+    return;
+  }
+
+  std::vector<hwc2_display_t> displays;
+  for (auto &pending : mPendingValidates) {
+    displays.push_back(pending.display);
+  }
+
+  std::vector<sdm::HWCSession::ValidateResult> results;
+  mClient.hwc_session_->ValidateDisplays(displays, &results);
+
+  // Results are reported in command order, each under its own display selection.
+  Display selected = mDisplay;
+  for (size_t i = 0; i < mPendingValidates.size(); i++) {
+    mDisplay = mPendingValidates[i].display;
+    mWriter.selectDisplay(mDisplay);
+    auto status = INT32(results[i].status);
+    auto err = static_cast<Error>(status);
+    if (status == HWC2_ERROR_NONE || status == HWC2_ERROR_HAS_CHANGES) {
+      err = postValidateDisplay(results[i].num_types, results[i].num_requests);
+    }
+    if (err != Error::NONE) {
+      mWriter.setError(mPendingValidates[i].commandLoc, err);
+    }
+  }
+  mPendingValidates.clear();
+
+  mDisplay = selected;
+  mWriter.selectDisplay(mDisplay);
+}
+
 bool QtiComposerClient::CommandReader::parseAcceptDisplayChanges(uint16_t length) {
   if (length != CommandWriter::kAcceptDisplayChangesLength) {
     return false;
@@ -360,6 +360,15 @@ class QtiComposerClient : public IQtiComposerClient {
     }
     Error postPresentDisplay(shared_ptr<Fence>* presentFence);
     Error postValidateDisplay(uint32_t& types_count, uint32_t& reqs_count);
+
+    // Validate commands deferred so that independent displays can be validated in parallel.
+    struct PendingValidate {
+      Display display;
+      uint32_t commandLoc;
+    };
+    bool deferValidateDisplay();
+    void flushPendingValidates();
+    std::vector<PendingValidate> mPendingValidates;
   };
 
   HWCSession *hwc_session_ = nullptr;
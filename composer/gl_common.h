@@ -36,6 +36,7 @@
 #include <string>
 
 #include "glengine.h"
+#include "EGLImageBuffer.h"
 #include "EGLImageWrapper.h"
 
 namespace sdm {
@@ -269,146 +269,126 @@ int HWCBufferAllocator::FreeBuffer(BufferInfo *buffer_info) {
   return err;
 }
 
+int HWCBufferAllocator::GetBufferDescriptor(void *buf, BufferDescriptorInfo *info) {
+  auto hnd = static_cast<const private_handle_t *>(buf);
+  if (!hnd || !info || private_handle_t::validate(hnd) != 0) {
+    return kErrorParameters;
+  }
+
+  // All of these are fixed at allocation and carried in the handle itself
+  info->version = kBufferDescriptorVersion;
+  info->fd = hnd->fd;
+  info->width = UINT32(hnd->width);
+  info->height = UINT32(hnd->height);
+  info->unaligned_width = UINT32(hnd->unaligned_width);
+  info->unaligned_height = UINT32(hnd->unaligned_height);
+  info->alloc_size = static_cast<uint32_t>(hnd->size);
+  info->id = hnd->id;
+  info->format = hnd->format;
+  info->private_flags = hnd->flags;
+  info->sdm_format = HWCLayer::GetSDMFormat(hnd->format, hnd->flags);
+  info->buffer_type = hnd->buffer_type;
+
+  return kErrorNone;
+}
+
 int HWCBufferAllocator::GetHeight(void *buf, uint32_t &height) {
-  uint32_t tmp_height;
-  auto err = qtigralloc::get(buf, QTI_ALIGNED_HEIGHT_IN_PIXELS, &tmp_height);
-  if (err == Error::NONE) {
-    height = tmp_height;
-    return kErrorNone;
+  BufferDescriptorInfo info;
+  if (GetBufferDescriptor(buf, &info) != kErrorNone) {
+    return kErrorParameters;
   }
-  return kErrorParameters;
+  height = info.height;
+  return kErrorNone;
 }
 
 int HWCBufferAllocator::GetWidth(void *buf, uint32_t &width) {
-  uint32_t tmp_width;
-  auto err = qtigralloc::get(buf, QTI_ALIGNED_WIDTH_IN_PIXELS, &tmp_width);
-  if (err == Error::NONE) {
-    width = tmp_width;
-    return kErrorNone;
+  BufferDescriptorInfo info;
+  if (GetBufferDescriptor(buf, &info) != kErrorNone) {
+    return kErrorParameters;
   }
-  return kErrorParameters;
+  width = info.width;
+  return kErrorNone;
 }
 
 int HWCBufferAllocator::GetUnalignedHeight(void *buf, uint32_t &height) {
-  uint64_t tmp_height;
-  auto err = Error::UNSUPPORTED;
-  mapper_->get(
-      buf, android::gralloc4::MetadataType_Height, [&](const auto _error, const auto _bytestream) {
-        if (_error == Error::NONE)
-          err = static_cast<Error>(android::gralloc4::decodeHeight(_bytestream, &tmp_height));
-      });
-  if (err == Error::NONE) {
-    height = static_cast<uint32_t>(tmp_height);
-    return kErrorNone;
+  BufferDescriptorInfo info;
+  if (GetBufferDescriptor(buf, &info) != kErrorNone) {
+    return kErrorParameters;
   }
-  return kErrorParameters;
+  height = info.unaligned_height;
+  return kErrorNone;
 }
 
 int HWCBufferAllocator::GetUnalignedWidth(void *buf, uint32_t &width) {
-  uint64_t tmp_width;
-  auto err = Error::UNSUPPORTED;
-  mapper_->get(
-      buf, android::gralloc4::MetadataType_Width, [&](const auto _error, const auto _bytestream) {
-        if (_error == Error::NONE)
-          err = static_cast<Error>(android::gralloc4::decodeWidth(_bytestream, &tmp_width));
-      });
-  if (err == Error::NONE) {
-    width = static_cast<uint32_t>(tmp_width);
-    return kErrorNone;
+  BufferDescriptorInfo info;
+  if (GetBufferDescriptor(buf, &info) != kErrorNone) {
+    return kErrorParameters;
   }
-  return kErrorParameters;
+  width = info.unaligned_width;
+  return kErrorNone;
 }
 
 int HWCBufferAllocator::GetFd(void *buf, int &fd) {
-  int tmp_fd;
-  auto err = qtigralloc::get(buf, QTI_FD, &tmp_fd);
-  if (err == Error::NONE) {
-    fd = tmp_fd;
-    return kErrorNone;
+  BufferDescriptorInfo info;
+  if (GetBufferDescriptor(buf, &info) != kErrorNone) {
+    return kErrorParameters;
   }
-  return kErrorParameters;
+  fd = info.fd;
+  return kErrorNone;
 }
 
 int HWCBufferAllocator::GetAllocationSize(void *buf, uint32_t &alloc_size) {
-  uint64_t tmp_alloc_size;
-  auto err = Error::UNSUPPORTED;
-  mapper_->get(buf, android::gralloc4::MetadataType_AllocationSize,
-               [&](const auto _error, const auto _bytestream) {
-                 if (_error == Error::NONE)
-                   err = static_cast<Error>(
-                       android::gralloc4::decodeAllocationSize(_bytestream, &tmp_alloc_size));
-               });
-  if (err == Error::NONE) {
-    alloc_size = static_cast<uint32_t>(tmp_alloc_size);
-    return kErrorNone;
+  BufferDescriptorInfo info;
+  if (GetBufferDescriptor(buf, &info) != kErrorNone) {
+    return kErrorParameters;
   }
-  return kErrorParameters;
+  alloc_size = info.alloc_size;
+  return kErrorNone;
 }
 
 int HWCBufferAllocator::GetBufferId(void *buf, uint64_t &id) {
-  uint64_t tmp_id;
-  auto err = Error::UNSUPPORTED;
-  mapper_->get(buf, android::gralloc4::MetadataType_BufferId,
-               [&](const auto _error, const auto _bytestream) {
-                 if (_error == Error::NONE)
-                   err =
-                       static_cast<Error>(android::gralloc4::decodeBufferId(_bytestream, &tmp_id));
-               });
-  if (err == Error::NONE) {
-    id = tmp_id;
-    return kErrorNone;
+  BufferDescriptorInfo info;
+  if (GetBufferDescriptor(buf, &info) != kErrorNone) {
+    return kErrorParameters;
   }
-  return kErrorParameters;
+  id = info.id;
+  return kErrorNone;
 }
 
 int HWCBufferAllocator::GetFormat(void *buf, int32_t &format) {
-  PixelFormat pixel_format;
-  auto err = Error::UNSUPPORTED;
-  mapper_->get(buf, android::gralloc4::MetadataType_PixelFormatRequested,
-               [&](const auto _error, const auto _bytestream) {
-                 if (_error == Error::NONE)
-                   err = static_cast<Error>(
-                       android::gralloc4::decodePixelFormatRequested(_bytestream, &pixel_format));
-               });
-  if (err == Error::NONE) {
-    format = static_cast<int32_t>(pixel_format);
-    return kErrorNone;
+  BufferDescriptorInfo info;
+  if (GetBufferDescriptor(buf, &info) != kErrorNone) {
+    return kErrorParameters;
   }
-  return kErrorParameters;
+  format = info.format;
+  return kErrorNone;
 }
 
 int HWCBufferAllocator::GetPrivateFlags(void *buf, int32_t &flags) {
-  int32_t tmp_flags;
-  auto err = qtigralloc::get(buf, QTI_PRIVATE_FLAGS, &tmp_flags);
-  if (err == Error::NONE) {
-    flags = tmp_flags;
-    return kErrorNone;
+  BufferDescriptorInfo info;
+  if (GetBufferDescriptor(buf, &info) != kErrorNone) {
+    return kErrorParameters;
   }
-  return kErrorParameters;
+  flags = info.private_flags;
+  return kErrorNone;
 }
 
 int HWCBufferAllocator::GetSDMFormat(void *buf, LayerBufferFormat &sdm_format) {
-  int32_t tmp_format, tmp_flags, err;
-  err = GetFormat(buf, tmp_format);
-  if (err != kErrorNone)
+  BufferDescriptorInfo info;
+  if (GetBufferDescriptor(buf, &info) != kErrorNone) {
     return kErrorUndefined;
-
-  err = GetPrivateFlags(buf, tmp_flags);
-  if (err != kErrorNone)
-    return kErrorUndefined;
-
-  sdm_format = HWCLayer::GetSDMFormat(tmp_format, tmp_flags);
+  }
+  sdm_format = info.sdm_format;
   return kErrorNone;
 }
 
 int HWCBufferAllocator::GetBufferType(void *buf, uint32_t &buffer_type) {
-  int32_t tmp_buffer_type;
-  auto err = qtigralloc::get(buf, QTI_BUFFER_TYPE, &tmp_buffer_type);
-  if (err == Error::NONE) {
-    buffer_type = tmp_buffer_type;
-    return kErrorNone;
+  BufferDescriptorInfo info;
+  if (GetBufferDescriptor(buf, &info) != kErrorNone) {
+    return kErrorParameters;
   }
-  return kErrorParameters;
+  buffer_type = info.buffer_type;
+  return kErrorNone;
 }
 
 int HWCBufferAllocator::GetBufferGeometry(void *buf, int32_t &slice_width, int32_t &slice_height) {
@@ -87,6 +87,7 @@ class HWCBufferAllocator : public BufferAllocator {
   int GetBufferType(void *buf, uint32_t &buffer_type);
   int GetBufferGeometry(void *buf, int32_t &slice_width, int32_t &slice_height);
   int GetCustomContentMetadata(void *buf, CustomContentMetadata *dest);
+  int GetBufferDescriptor(void *buf, BufferDescriptorInfo *info);
 
  private:
   int GetGrallocInstance();
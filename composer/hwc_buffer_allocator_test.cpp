@@ -0,0 +1,172 @@
+/*
+* Copyright (c) 2024 The Linux Foundation. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of The Linux Foundation nor the names of its
+*       contributors may be used to endorse or promote products derived
+*       from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+* OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+* IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+#include <QtiGrallocPriv.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "hwc_buffer_allocator.h"
+
+using namespace sdm;
+
+namespace {
+
+// The descriptor is filled from the handle alone, so a handle built in place is enough and
+// no mapper service is needed.
+class HWCBufferAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override { handle_ = NewHandle(qtigralloc::PRIV_FLAGS_UBWC_ALIGNED); }
+
+  void TearDown() override {
+    for (auto hnd : handles_) {
+      free(hnd);
+    }
+  }
+
+  // Fills the handle the way gralloc does, which allocates it with malloc
+  private_handle_t *NewHandle(int flags) {
+    auto hnd = static_cast<private_handle_t *>(malloc(sizeof(private_handle_t)));
+    memset(hnd, 0, sizeof(private_handle_t));
+    hnd->version = static_cast<int>(sizeof(native_handle));
+    hnd->numInts = private_handle_t::NumInts();
+    hnd->numFds = private_handle_t::kNumFds;
+    hnd->magic = private_handle_t::kMagic;
+    hnd->fd = kFd;
+    hnd->fd_metadata = kMetaFd;
+    hnd->flags = flags;
+    hnd->width = 1088;
+    hnd->height = 1920;
+    hnd->unaligned_width = 1080;
+    hnd->unaligned_height = 1916;
+    hnd->format = static_cast<int>(PixelFormat::RGBA_8888);
+    hnd->buffer_type = kBufferType;
+    hnd->layer_count = 1;
+    hnd->size = kSize;
+    hnd->id = kId;
+    handles_.push_back(hnd);
+    return hnd;
+  }
+
+  static constexpr int kFd = 41;
+  static constexpr int kMetaFd = 42;
+  static constexpr int kBufferType = 1;
+  static constexpr unsigned int kSize = 8355840;
+  static constexpr uint64_t kId = 0x1234000000005678;
+
+  HWCBufferAllocator allocator_;
+  private_handle_t *handle_ = nullptr;
+  std::vector<private_handle_t *> handles_;
+};
+
+TEST_F(HWCBufferAllocatorTest, DescriptorMatchesHandle) {
+  BufferDescriptorInfo info;
+  ASSERT_EQ(allocator_.GetBufferDescriptor(handle_, &info), kErrorNone);
+
+  EXPECT_EQ(info.version, kBufferDescriptorVersion);
+  EXPECT_EQ(info.fd, kFd);
+  EXPECT_EQ(info.width, 1088u);
+  EXPECT_EQ(info.height, 1920u);
+  EXPECT_EQ(info.unaligned_width, 1080u);
+  EXPECT_EQ(info.unaligned_height, 1916u);
+  EXPECT_EQ(info.alloc_size, kSize);
+  EXPECT_EQ(info.id, kId);
+  EXPECT_EQ(info.format, static_cast<int32_t>(PixelFormat::RGBA_8888));
+  EXPECT_EQ(info.private_flags, qtigralloc::PRIV_FLAGS_UBWC_ALIGNED);
+  EXPECT_EQ(info.sdm_format, kFormatRGBA8888Ubwc);
+  EXPECT_EQ(info.buffer_type, UINT32(kBufferType));
+}
+
+TEST_F(HWCBufferAllocatorTest, GettersMatchDescriptor) {
+  BufferDescriptorInfo info;
+  ASSERT_EQ(allocator_.GetBufferDescriptor(handle_, &info), kErrorNone);
+
+  uint32_t value = 0;
+  ASSERT_EQ(allocator_.GetWidth(handle_, value), kErrorNone);
+  EXPECT_EQ(value, info.width);
+  ASSERT_EQ(allocator_.GetHeight(handle_, value), kErrorNone);
+  EXPECT_EQ(value, info.height);
+  ASSERT_EQ(allocator_.GetUnalignedWidth(handle_, value), kErrorNone);
+  EXPECT_EQ(value, info.unaligned_width);
+  ASSERT_EQ(allocator_.GetUnalignedHeight(handle_, value), kErrorNone);
+  EXPECT_EQ(value, info.unaligned_height);
+  ASSERT_EQ(allocator_.GetAllocationSize(handle_, value), kErrorNone);
+  EXPECT_EQ(value, info.alloc_size);
+  ASSERT_EQ(allocator_.GetBufferType(handle_, value), kErrorNone);
+  EXPECT_EQ(value, info.buffer_type);
+
+  int fd = -1;
+  ASSERT_EQ(allocator_.GetFd(handle_, fd), kErrorNone);
+  EXPECT_EQ(fd, info.fd);
+  uint64_t id = 0;
+  ASSERT_EQ(allocator_.GetBufferId(handle_, id), kErrorNone);
+  EXPECT_EQ(id, info.id);
+  int32_t format = 0;
+  ASSERT_EQ(allocator_.GetFormat(handle_, format), kErrorNone);
+  EXPECT_EQ(format, info.format);
+  int32_t flags = 0;
+  ASSERT_EQ(allocator_.GetPrivateFlags(handle_, flags), kErrorNone);
+  EXPECT_EQ(flags, info.private_flags);
+  LayerBufferFormat sdm_format = kFormatInvalid;
+  ASSERT_EQ(allocator_.GetSDMFormat(handle_, sdm_format), kErrorNone);
+  EXPECT_EQ(sdm_format, info.sdm_format);
+}
+
+TEST_F(HWCBufferAllocatorTest, LinearHandleMapsToLinearFormat) {
+  private_handle_t *linear = NewHandle(0);
+  BufferDescriptorInfo info;
+  ASSERT_EQ(allocator_.GetBufferDescriptor(linear, &info), kErrorNone);
+  EXPECT_EQ(info.sdm_format, kFormatRGBA8888);
+}
+
+TEST_F(HWCBufferAllocatorTest, InvalidHandleRejected) {
+  BufferDescriptorInfo info;
+  EXPECT_EQ(allocator_.GetBufferDescriptor(nullptr, &info), kErrorParameters);
+  EXPECT_EQ(allocator_.GetBufferDescriptor(handle_, nullptr), kErrorParameters);
+
+  // A handle whose magic does not match is not a gralloc buffer.
+  private_handle_t *stale = NewHandle(0);
+  stale->magic = 0;
+  EXPECT_EQ(allocator_.GetBufferDescriptor(stale, &info), kErrorParameters);
+
+  uint32_t width = 0;
+  EXPECT_EQ(allocator_.GetWidth(stale, width), kErrorParameters);
+  LayerBufferFormat sdm_format = kFormatRGBA8888;
+  EXPECT_EQ(allocator_.GetSDMFormat(stale, sdm_format), kErrorUndefined);
+  EXPECT_EQ(sdm_format, kFormatRGBA8888);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
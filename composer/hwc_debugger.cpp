@@ -66,11 +66,26 @@
 #include <utils/constants.h>
 #include <cutils/properties.h>
 #include <display_properties.h>
+#include <property_store.h>
+#include <sys/system_properties.h>
 
 #include "hwc_debugger.h"
 
 namespace sdm {
 
+// Reads system properties. The global property area serial changes on every property update, so
+// cached values are refreshed without a per-key backend read.
+class SystemPropertyBackend : public display::PropertyBackend {
+ public:
+  virtual int Read(const char *property_name, char *value) {
+    return property_get(property_name, value, NULL);
+  }
+  virtual uint32_t Serial() { return __system_property_area_serial(); }
+};
+
+static SystemPropertyBackend g_property_backend;
+static display::PropertyStore g_property_store(&g_property_backend);
+
 HWCDebugHandler HWCDebugHandler::debug_handler_;
 
 HWCDebugHandler::HWCDebugHandler() {
@@ -280,10 +295,7 @@ int  HWCDebugHandler::GetIdleTimeoutMs() {
 }
 
 int HWCDebugHandler::GetProperty(const char *property_name, int *value) {
-  char property[PROPERTY_VALUE_MAX];
-
-  if (property_get(property_name, property, NULL) > 0) {
-    *value = atoi(property);
+  if (g_property_store.GetProperty(property_name, value) == 0) {
     return kErrorNone;
   }
 
@@ -291,7 +303,7 @@ int HWCDebugHandler::GetProperty(const char *property_name, int *value) {
 }
 
 int HWCDebugHandler::GetProperty(const char *property_name, char *value) {
-  if (property_get(property_name, value, NULL) > 0) {
+  if (g_property_store.GetProperty(property_name, value) == 0) {
     return kErrorNone;
   }
 
@@ -618,6 +618,8 @@ HWC2::Error HWCDisplay::CreateLayer(hwc2_layer_t *out_layer_id) {
   HWCLayer *layer = *layer_set_.emplace(new HWCLayer(id_, buffer_allocator_));
   if (disable_sdr_histogram_)
     layer->IgnoreSdrHistogramMetadata(true);
+  if (content_fps_detection_)
+    layer->EnableContentFrameRate(true);
 
   layer_map_.emplace(std::make_pair(layer->GetId(), layer));
   *out_layer_id = layer->GetId();
@@ -822,6 +824,7 @@ void HWCDisplay::BuildLayerStack() {
     layer->layer_id = hwc_layer->GetId();
     layer->layer_name = hwc_layer->GetName();
     layer->geometry_changes = hwc_layer->GetGeometryChanges();
+    layer->flags.buffer_updated = hwc_layer->IsBufferUpdated();
     layer_stack_.layers.push_back(layer);
   }
 
@@ -835,6 +838,7 @@ void HWCDisplay::BuildLayerStack() {
   sdm_client_target->layer_id = client_target_->GetId();
   sdm_client_target->geometry_changes = client_target_->GetGeometryChanges();
   sdm_client_target->flags.updating = IsLayerUpdating(client_target_);
+  sdm_client_target->flags.buffer_updated = client_target_->IsBufferUpdated();
   sdm_client_target->layer_name = client_target_->GetName();
 
   // Derive client target dataspace based on the color mode - bug/115482728
@@ -1471,6 +1475,9 @@ DisplayError HWCDisplay::HandleEvent(DisplayEvent event) {
     } break;
     case kIdleTimeout:
       ReqPerfHintRelease();
+      if (tone_mapper_) {
+        tone_mapper_->TrimIdleSessions();
+      }
       break;
     default:
       DLOGW("Unknown event: %d", event);
@@ -1805,7 +1812,7 @@ HWC2::Error HWCDisplay::CommitLayerStack(void) {
         DLOGE("Error handling HDR in ToneMapper");
       }
     } else {
-      tone_mapper_->Terminate();
+      tone_mapper_->Release();
     }
   }
 
@@ -1849,9 +1856,11 @@ HWC2::Error HWCDisplay::PostCommitLayerStack(shared_ptr<Fence> *out_retire_fence
 
   RetrieveFences(out_retire_fence);
   client_target_->ResetGeometryChanges();
+  client_target_->ResetBufferUpdate();
 
   for (auto hwc_layer : layer_set_) {
     hwc_layer->ResetGeometryChanges();
+    hwc_layer->ResetBufferUpdate();
     Layer *layer = hwc_layer->GetSDMLayer();
     LayerBuffer *layer_buffer = &layer->input_buffer;
     layer->request.flags = {};
@@ -1996,13 +2005,10 @@ void HWCDisplay::DumpInputBuffers() {
     char dump_file_name[PATH_MAX];
     size_t result = 0;
 
-    uint32_t width = 0, height = 0, alloc_size = 0;
-    int32_t format = 0;
-
-    buffer_allocator_->GetWidth((void *)handle, width);
-    buffer_allocator_->GetHeight((void *)handle, height);
-    buffer_allocator_->GetFormat((void *)handle, format);
-    buffer_allocator_->GetAllocationSize((void *)handle, alloc_size);
+    BufferDescriptorInfo info;
+    buffer_allocator_->GetBufferDescriptor((void *)handle, &info);
+    uint32_t width = info.width, height = info.height, alloc_size = info.alloc_size;
+    int32_t format = info.format;
 
     snprintf(dump_file_name, sizeof(dump_file_name), "%s/input_layer%d_%dx%d_format%d_frame%d.raw",
              dir_path, i, width, height, format, dump_frame_index_);
@@ -2587,6 +2593,20 @@ void HWCDisplay::Dump(std::ostringstream *os) {
     color_mode_->Dump(os);
   }
 
+  if (tone_mapper_) {
+    tone_mapper_->Dump(os);
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(cwb_mutex_);
+    if (cwb_stats_.requested || cwb_stats_.rejected) {
+      *os << "\nCWB: requested " << cwb_stats_.requested << " completed " << cwb_stats_.completed
+          << " failed " << cwb_stats_.failed << " timed out " << cwb_stats_.timed_out
+          << " rejected " << cwb_stats_.rejected << " in flight " << cwb_buffer_map_.size()
+          << " buffer cache hits " << cwb_stats_.cache_hits << std::endl;
+    }
+  }
+
   if (display_intf_) {
     *os << "\n------------SDM----------------\n";
     *os << display_intf_->Dump();
@@ -2673,7 +2693,11 @@ bool HWCDisplay::CanSkipSdmPrepare(uint32_t *num_types, uint32_t *num_requests)
 }
 
 void HWCDisplay::UpdateRefreshRate() {
+  int64_t now = systemTime(SYSTEM_TIME_MONOTONIC);
   for (auto hwc_layer : layer_set_) {
+    if (content_fps_detection_) {
+      hwc_layer->UpdateContentFrameRate(current_refresh_rate_, now, content_fps_reprobe_ns_);
+    }
     if (hwc_layer->HasMetaDataRefreshRate()) {
       continue;
     }
@@ -3258,6 +3282,7 @@ HWC2::Error HWCDisplay::SetReadbackBuffer(const native_handle_t *buffer,
 
   if (!buffer) {
     DLOGE("Bad parameter: handle is null");
+    cwb_stats_.rejected++;
     return HWC2::Error::BadParameter;
   }
 
@@ -3265,67 +3290,54 @@ HWC2::Error HWCDisplay::SetReadbackBuffer(const native_handle_t *buffer,
   gralloc::GetMetaDataValue(hdl, (int64_t)qtigralloc::MetadataType_FD.value, &fd);
   if (fd < 0) {
     DLOGE("Bad parameter: fd is null");
+    cwb_stats_.rejected++;
     return HWC2::Error::BadParameter;
   }
 
-  LayerBuffer output_buffer = {};
-  // Configure the output buffer as Readback buffer
-  auto err = gralloc::GetMetaDataValue(
-      hdl, (int64_t)qtigralloc::MetadataType_AlignedWidthInPixels.value, &output_buffer.width);
-  if (err != gralloc::Error::NONE) {
-    DLOGE("Failed to retrieve aligned width");
-  }
-  err = gralloc::GetMetaDataValue(
-      hdl, (int64_t)qtigralloc::MetadataType_AlignedHeightInPixels.value, &output_buffer.height);
-  if (err != gralloc::Error::NONE) {
-    DLOGE("Failed to retrieve aligned height");
-  }
-  err = gralloc::GetMetaDataValue(hdl, (int64_t)StandardMetadataType::WIDTH,
-                                  &output_buffer.unaligned_width);
-  if (err != gralloc::Error::NONE) {
-    DLOGE("Failed to retrieve unaligned width");
-  }
-  err = gralloc::GetMetaDataValue(hdl, (int64_t)StandardMetadataType::HEIGHT,
-                                  &output_buffer.unaligned_height);
-  if (err != gralloc::Error::NONE) {
-    DLOGE("Failed to retrieve unaligned height");
-  }
-  int format, flag;
-  err = gralloc::GetMetaDataValue(hdl, (int64_t)StandardMetadataType::PIXEL_FORMAT_REQUESTED,
-                                  &format);
-  if (err != gralloc::Error::NONE) {
-    DLOGE("Failed to retrieve format");
-  }
-  err = gralloc::GetMetaDataValue(hdl, (int64_t)QTI_PRIVATE_FLAGS, &flag);
+  uint64_t handle_id = 0;
+  auto err = gralloc::GetMetaDataValue(hdl, (int64_t)StandardMetadataType::BUFFER_ID, &handle_id);
   if (err != gralloc::Error::NONE) {
-    DLOGE("Failed to retrieve flag");
+    DLOGE("Failed to retrieve buffer id");
   }
-  output_buffer.format = HWCLayer::GetSDMFormat(format, flag);
-  err = gralloc::GetMetaDataValue(hdl, (int64_t)QTI_FD, &output_buffer.planes[0].fd);
-  if (err != gralloc::Error::NONE) {
-    DLOGE("Failed to retrieve file descriptor");
+
+  LayerBuffer output_buffer = {};
+  bool cache_hit = false;
+  {
+    std::unique_lock<std::mutex> lock(cwb_mutex_);
+    auto cached = std::find_if(cwb_buffer_cache_.begin(), cwb_buffer_cache_.end(),
+                               [handle_id](const LayerBuffer &buf) {
+                                 return handle_id && buf.handle_id == handle_id;
+                               });
+    if (cached != cwb_buffer_cache_.end()) {
+      // Buffer of a streaming client's ring, its description has been validated already.
+      output_buffer = *cached;
+      cwb_buffer_cache_.erase(cached);
+      cwb_stats_.cache_hits++;
+      cache_hit = true;
+    }
   }
-  err = gralloc::GetMetaDataValue(hdl, (int64_t)QTI_ALIGNED_WIDTH_IN_PIXELS,
-                                  &output_buffer.planes[0].stride);
-  if (err != gralloc::Error::NONE) {
-    DLOGE("Failed to retrieve stride");
+
+  if (!cache_hit) {
+    HWC2::Error status = GetReadbackBufferConfig(hdl, &output_buffer);
+    if (status != HWC2::Error::None) {
+      cwb_stats_.rejected++;
+      return status;
+    }
+    output_buffer.handle_id = handle_id;
   }
-  err = gralloc::GetMetaDataValue(hdl, (int64_t)StandardMetadataType::BUFFER_ID,
-                                  &output_buffer.handle_id);
-  if (err != gralloc::Error::NONE) {
-    DLOGE("Failed to retrieve buffer id");
+
+  {
+    std::unique_lock<std::mutex> lock(cwb_mutex_);
+    cwb_buffer_cache_.push_front(output_buffer);
+    if (cwb_buffer_cache_.size() > kCwbBufferCacheSize) {
+      cwb_buffer_cache_.pop_back();
+    }
   }
 
+  // File descriptor and fence belong to this request's handle.
+  output_buffer.planes[0].fd = fd;
   output_buffer.acquire_fence = acquire_fence;
 
-  if (output_buffer.format == kFormatInvalid) {
-    DLOGW("Format %d is not supported by SDM", format);
-    return HWC2::Error::BadParameter;
-  } else if (!display_intf_->IsWriteBackSupportedFormat(output_buffer.format)) {
-    DLOGW("WB doesn't support color format : %s .", GetFormatString(output_buffer.format));
-    return HWC2::Error::BadParameter;
-  }
-
   CwbConfig config = cwb_config;
   LayerRect &roi = config.cwb_roi;
   LayerRect &full_rect = config.cwb_full_rect;
@@ -3335,6 +3347,7 @@ HWC2::Error HWCDisplay::SetReadbackBuffer(const native_handle_t *buffer,
   error = display_intf_->CaptureCwb(output_buffer, config);
   if (error) {
     DLOGE("CaptureCwb failed");
+    cwb_stats_.rejected++;
     if (error == kErrorParameters) {
       return HWC2::Error::BadParameter;
     } else {
@@ -3356,6 +3369,56 @@ HWC2::Error HWCDisplay::SetReadbackBuffer(const native_handle_t *buffer,
            full_rect.left, full_rect.top, full_rect.right, full_rect.bottom);
 
   DLOGV_IF(kTagClient, "Successfully configured the output buffer: cwb_client %d", client);
+  cwb_stats_.requested++;
+
+  return HWC2::Error::None;
+}
+
+HWC2::Error HWCDisplay::GetReadbackBufferConfig(void *hdl, LayerBuffer *output_buffer) {
+  auto err = gralloc::GetMetaDataValue(
+      hdl, (int64_t)qtigralloc::MetadataType_AlignedWidthInPixels.value, &output_buffer->width);
+  if (err != gralloc::Error::NONE) {
+    DLOGE("Failed to retrieve aligned width");
+  }
+  err = gralloc::GetMetaDataValue(
+      hdl, (int64_t)qtigralloc::MetadataType_AlignedHeightInPixels.value, &output_buffer->height);
+  if (err != gralloc::Error::NONE) {
+    DLOGE("Failed to retrieve aligned height");
+  }
+  err = gralloc::GetMetaDataValue(hdl, (int64_t)StandardMetadataType::WIDTH,
+                                  &output_buffer->unaligned_width);
+  if (err != gralloc::Error::NONE) {
+    DLOGE("Failed to retrieve unaligned width");
+  }
+  err = gralloc::GetMetaDataValue(hdl, (int64_t)StandardMetadataType::HEIGHT,
+                                  &output_buffer->unaligned_height);
+  if (err != gralloc::Error::NONE) {
+    DLOGE("Failed to retrieve unaligned height");
+  }
+  int format, flag;
+  err = gralloc::GetMetaDataValue(hdl, (int64_t)StandardMetadataType::PIXEL_FORMAT_REQUESTED,
+                                  &format);
+  if (err != gralloc::Error::NONE) {
+    DLOGE("Failed to retrieve format");
+  }
+  err = gralloc::GetMetaDataValue(hdl, (int64_t)QTI_PRIVATE_FLAGS, &flag);
+  if (err != gralloc::Error::NONE) {
+    DLOGE("Failed to retrieve flag");
+  }
+  output_buffer->format = HWCLayer::GetSDMFormat(format, flag);
+  err = gralloc::GetMetaDataValue(hdl, (int64_t)QTI_ALIGNED_WIDTH_IN_PIXELS,
+                                  &output_buffer->planes[0].stride);
+  if (err != gralloc::Error::NONE) {
+    DLOGE("Failed to retrieve stride");
+  }
+
+  if (output_buffer->format == kFormatInvalid) {
+    DLOGW("Format %d is not supported by SDM", format);
+    return HWC2::Error::BadParameter;
+  } else if (!display_intf_->IsWriteBackSupportedFormat(output_buffer->format)) {
+    DLOGW("WB doesn't support color format : %s .", GetFormatString(output_buffer->format));
+    return HWC2::Error::BadParameter;
+  }
 
   return HWC2::Error::None;
 }
@@ -3513,6 +3576,13 @@ void HWCDisplay::HandleFrameOutput() {
   }
 }
 
+void HWCDisplay::SetFrameCaptureStatus(CWBReleaseFenceError status) {
+  frame_capture_status_ = (status == kCWBReleaseFenceWaitTimedOut) ? -ETIME : (status) ? -1 : 0;
+  frame_capture_buffer_queued_ = false;
+
+  DLOGV_IF(kTagQDCM, "Frame captured: status %d", frame_capture_status_.load());
+}
+
 void HWCDisplay::HandleFrameDump() {
   if (!dump_frame_count_) {
     return;
@@ -3653,12 +3723,18 @@ void HWCDisplay::NotifyCwbDone(int32_t status, const LayerBuffer& buffer) {
 
     if (!status) {
       cwb_cap_status.status = kCWBReleaseFenceSignaled;
+      cwb_stats_.completed++;
     } else if (status == -ETIME) {
       cwb_cap_status.status = kCWBReleaseFenceWaitTimedOut;
+      cwb_stats_.timed_out++;
     } else {
       cwb_cap_status.status = kCWBReleaseFenceUnknownError;
+      cwb_stats_.failed++;
     }
     cwb_buffer_map_.erase(handle_id);
+    if (client == kCWBClientColor) {
+      SetFrameCaptureStatus(cwb_cap_status.status);
+    }
     if (client == kCWBClientFrameDump || client == kCWBClientColor) {
       cwb_cv_.notify_one();
     } else if (client == kCWBClientExternal && event_handler_) {
@@ -34,7 +34,9 @@
 #include <private/color_params.h>
 #include <sys/stat.h>
 #include <algorithm>
+#include <atomic>
 #include <bitset>
+#include <deque>
 #include <map>
 #include <queue>
 #include <set>
@@ -552,6 +554,7 @@ class HWCDisplay : public DisplayEventHandler {
   // CWB related methods
   void HandleFrameOutput();
   void HandleFrameDump();
+  void SetFrameCaptureStatus(CWBReleaseFenceError status);
   virtual void HandleFrameCapture(){};
 
   bool layer_stack_invalid_ = true;
@@ -580,6 +583,8 @@ class HWCDisplay : public DisplayEventHandler {
   uint32_t qsync_fps_ = 0;
   uint32_t current_refresh_rate_ = 0;
   bool use_metadata_refresh_rate_ = false;
+  bool content_fps_detection_ = false;
+  int64_t content_fps_reprobe_ns_ = kContentFpsReprobeMs * 1000000;
   bool boot_animation_completed_ = false;
   bool shutdown_pending_ = false;
   std::bitset<kSecureMax> active_secure_sessions_ = 0;
@@ -632,8 +637,9 @@ class HWCDisplay : public DisplayEventHandler {
   CwbConfig output_buffer_cwb_config_ = {};
 
   // Members for 1 frame capture in a client provided buffer
-  bool frame_capture_buffer_queued_ = false;
-  int frame_capture_status_ = -EAGAIN;
+  // Completed from the CWB notification, polled by the client.
+  std::atomic<bool> frame_capture_buffer_queued_ = false;
+  std::atomic<int> frame_capture_status_ = -EAGAIN;
   uint32_t geometry_changes_ = GeometryChanges::kNone;
   bool is_multi_display_ = false;
   buffer_handle_t client_target_handle_ = 0;
@@ -645,11 +651,27 @@ class HWCDisplay : public DisplayEventHandler {
   std::condition_variable cwb_cv_;
   std::map<CWBClient, CWBCaptureResponse> cwb_capture_status_map_;
   static constexpr unsigned int kCwbWaitMs = 100;
+  static constexpr int64_t kContentFpsReprobeMs = 2000;
+  // Readback buffer descriptions of recently requested CWB buffers, most recent first. Streaming
+  // clients cycle through a small ring of buffers, for which the gralloc metadata queries and
+  // format validation are then skipped.
+  static constexpr uint32_t kCwbBufferCacheSize = 4;
+  std::deque<LayerBuffer> cwb_buffer_cache_ = {};
+  struct CwbStats {
+    std::atomic<uint64_t> requested = 0;
+    std::atomic<uint64_t> rejected = 0;   // Requests dropped before reaching the CWB manager
+    std::atomic<uint64_t> completed = 0;
+    std::atomic<uint64_t> failed = 0;
+    std::atomic<uint64_t> timed_out = 0;
+    std::atomic<uint64_t> cache_hits = 0;
+  };
+  CwbStats cwb_stats_ = {};
   bool validate_done_ = false;
 
  private:
   bool CanSkipSdmPrepare(uint32_t *num_types, uint32_t *num_requests);
   void WaitOnPreviousFence();
+  HWC2::Error GetReadbackBufferConfig(void *hdl, LayerBuffer *output_buffer);
   qService::QService *qservice_ = NULL;
   DisplayClass display_class_;
   uint32_t geometry_changes_on_doze_suspend_ = GeometryChanges::kNone;
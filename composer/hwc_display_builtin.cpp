@@ -128,6 +128,15 @@ int HWCDisplayBuiltIn::Init() {
     layer_stack_.flags.use_metadata_refresh_rate = false;
   }
 
+  int enable_content_fps = 0;
+  HWCDebugHandler::Get()->GetProperty(ENABLE_CONTENT_FPS_DETECTION_PROP, &enable_content_fps);
+  content_fps_detection_ = layer_stack_.flags.use_metadata_refresh_rate && enable_content_fps;
+  int content_fps_reprobe_ms = 0;
+  HWCDebugHandler::Get()->GetProperty(CONTENT_FPS_REPROBE_MS_PROP, &content_fps_reprobe_ms);
+  if (content_fps_reprobe_ms > 0) {
+    content_fps_reprobe_ns_ = int64_t(content_fps_reprobe_ms) * 1000000;
+  }
+
   int status = HWCDisplay::Init();
   if (status) {
     return status;
@@ -750,21 +759,15 @@ void HWCDisplayBuiltIn::SetIdleTimeoutMs(uint32_t timeout_ms, uint32_t inactive_
 }
 
 void HWCDisplayBuiltIn::HandleFrameCapture() {
-  auto ret = kCWBReleaseFenceErrorNone;
-  {
-    std::unique_lock<std::mutex> lock(cwb_mutex_);
-    auto &cwb_resp = cwb_capture_status_map_[kCWBClientColor];
-    // If CWB request status is not notified, then need to wait for the notification.
-    if (cwb_resp.status == kCWBReleaseFenceNotChecked) {
-      cwb_cv_.wait(lock);
-    }
-    ret = cwb_resp.status;
+  std::lock_guard<std::mutex> lock(cwb_mutex_);
+  auto &cwb_resp = cwb_capture_status_map_[kCWBClientColor];
+  // The commit does not wait for the capture. If the CWB request status is not notified yet,
+  // NotifyCwbDone() completes the capture and the client keeps polling GetFrameCaptureStatus().
+  if (cwb_resp.status == kCWBReleaseFenceNotChecked) {
+    return;
   }
 
-  frame_capture_status_ = (ret == kCWBReleaseFenceWaitTimedOut) ? -ETIME : (ret) ? -1 : 0;
-  frame_capture_buffer_queued_ = false;
-
-  DLOGV_IF(kTagQDCM, "Frame captured: frame_capture_buffer_queued_ %d",frame_capture_buffer_queued_);
+  SetFrameCaptureStatus(cwb_resp.status);
 }
 
 int HWCDisplayBuiltIn::FrameCaptureAsync(const BufferInfo &output_buffer_info,
@@ -98,18 +98,13 @@ HWC2::Error HWCDisplayVirtual::DumpVDSBuffer() {
         DLOGE("Failed to map output buffer, error = %d", error);
         return HWC2::Error::BadParameter;
       }
-      uint32_t width, height, alloc_size = 0;
-      int32_t format, flags = 0;
-      buffer_allocator_->GetWidth((void *)output_handle, width);
-      buffer_allocator_->GetHeight((void *)output_handle, height);
-      buffer_allocator_->GetFormat((void *)output_handle, format);
-      buffer_allocator_->GetPrivateFlags((void *)output_handle, flags);
-      buffer_allocator_->GetAllocationSize((void *)output_handle, alloc_size);
-
-      buffer_info.buffer_config.width = width;
-      buffer_info.buffer_config.height = height;
-      buffer_info.buffer_config.format = HWCLayer::GetSDMFormat(format, flags);
-      buffer_info.alloc_buffer_info.size = alloc_size;
+      BufferDescriptorInfo info;
+      buffer_allocator_->GetBufferDescriptor((void *)output_handle, &info);
+
+      buffer_info.buffer_config.width = info.width;
+      buffer_info.buffer_config.height = info.height;
+      buffer_info.buffer_config.format = info.sdm_format;
+      buffer_info.alloc_buffer_info.size = info.alloc_size;
       DumpOutputBuffer(buffer_info, base_ptr, layer_stack_.retire_fence);
 
       int release_fence = -1;
@@ -132,9 +127,9 @@ HWC2::Error HWCDisplayVirtual::SetOutputBuffer(buffer_handle_t buf,
   const native_handle_t *output_handle = static_cast<const native_handle_t *>(buf);
 
   if (output_handle) {
-    int output_handle_format, output_handle_flags = 0;
-    buffer_allocator_->GetPrivateFlags((void *)output_handle, output_handle_flags);
-    buffer_allocator_->GetFormat((void *)output_handle, output_handle_format);
+    BufferDescriptorInfo info;
+    buffer_allocator_->GetBufferDescriptor((void *)output_handle, &info);
+    int output_handle_format = info.format, output_handle_flags = info.private_flags;
     ColorMetaData color_metadata = {};
 
     if (output_handle_format == static_cast<int>(PixelFormat::RGBA_8888)) {
@@ -164,13 +159,9 @@ HWC2::Error HWCDisplayVirtual::SetOutputBuffer(buffer_handle_t buf,
     }
 
     // ToDo: Need to extend for non-RGB formats
-    int fd = 0;
-    uint32_t width = 0;
-    buffer_allocator_->GetFd((void *)output_handle, fd);
-    buffer_allocator_->GetWidth((void *)output_handle, width);
-    output_buffer_->planes[0].fd = fd;
+    output_buffer_->planes[0].fd = info.fd;
     output_buffer_->planes[0].offset = 0;
-    output_buffer_->planes[0].stride = width;
+    output_buffer_->planes[0].stride = info.width;
   }
 
   output_buffer_->acquire_fence = release_fence;
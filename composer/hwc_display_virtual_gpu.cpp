@@ -143,10 +143,13 @@ HWC2::Error HWCDisplayVirtualGPU::SetOutputBuffer(buffer_handle_t buf,
   }
 
   native_handle_t *hnd = const_cast<native_handle_t *>(buf);
-  buffer_allocator_->GetWidth(hnd, output_buffer_->width);
-  buffer_allocator_->GetHeight(hnd, output_buffer_->height);
-  buffer_allocator_->GetUnalignedWidth(hnd, output_buffer_->unaligned_width);
-  buffer_allocator_->GetUnalignedHeight(hnd, output_buffer_->unaligned_height);
+  BufferDescriptorInfo info;
+  if (buffer_allocator_->GetBufferDescriptor(hnd, &info) == kErrorNone) {
+    output_buffer_->width = info.width;
+    output_buffer_->height = info.height;
+    output_buffer_->unaligned_width = info.unaligned_width;
+    output_buffer_->unaligned_height = info.unaligned_height;
+  }
 
   // Update active dimensions.
   if (qtigralloc::getMetadataState(hnd, android::gralloc4::MetadataType_Crop.value)) {
@@ -157,10 +160,8 @@ HWC2::Error HWCDisplayVirtualGPU::SetOutputBuffer(buffer_handle_t buf,
       // Update buffer width and height.
       int new_aligned_w = 0;
       int new_aligned_h = 0;
-      int output_handle_format = 0;;
-      buffer_allocator_->GetFormat(hnd, output_handle_format);
       buffer_allocator_->GetAlignedWidthAndHeight(INT(slice_width), INT(slice_height),
-                                                  output_handle_format, 0, &new_aligned_w,
+                                                  info.format, 0, &new_aligned_w,
                                                   &new_aligned_h);
       output_buffer_->width = UINT32(new_aligned_w);
       output_buffer_->height = UINT32(new_aligned_h);
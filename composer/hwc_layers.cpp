@@ -59,7 +59,10 @@
 
 #include "hwc_layers.h"
 #include <utils/debug.h>
+#include <utils/rect.h>
+#include <errno.h>
 #include <stdint.h>
+#include <string.h>
 #include <utility>
 #include <cmath>
 #include <gr_utils.h>
@@ -71,6 +74,83 @@ namespace sdm {
 
 std::atomic<hwc2_layer_t> HWCLayer::next_id_(1);
 
+HWCBufferFdRegistry *HWCBufferFdRegistry::GetInstance() {
+  static HWCBufferFdRegistry *registry = new HWCBufferFdRegistry();
+  return registry;
+}
+
+int HWCBufferFdRegistry::Acquire(uint64_t buffer_id, int fd) {
+  std::lock_guard<std::mutex> lock(lock_);
+  auto it = entries_.find(buffer_id);
+  if (it == entries_.end()) {
+    int dup_fd = ::dup(fd);
+    if (dup_fd < 0) {
+      DLOGE("dup failed for buffer id %" PRIu64 ", error = %s", buffer_id, strerror(errno));
+      return -1;
+    }
+    it = entries_.emplace(buffer_id, Entry()).first;
+    it->second.fd = dup_fd;
+  } else if (!it->second.refs && !it->second.evicted) {
+    idle_.erase(it->second.idle_pos);
+  }
+
+  it->second.refs++;
+  return it->second.fd;
+}
+
+void HWCBufferFdRegistry::Release(uint64_t buffer_id) {
+  std::lock_guard<std::mutex> lock(lock_);
+  auto it = entries_.find(buffer_id);
+  if (it == entries_.end() || !it->second.refs) {
+    return;
+  }
+
+  if (--it->second.refs) {
+    return;
+  }
+
+  if (it->second.evicted) {
+    CloseLocked(it);
+    return;
+  }
+
+  it->second.idle_pos = idle_.insert(idle_.end(), buffer_id);
+  while (idle_.size() > kMaxIdleEntries) {
+    CloseLocked(entries_.find(idle_.front()));
+  }
+}
+
+void HWCBufferFdRegistry::Evict(buffer_handle_t buffer) {
+  uint64_t buffer_id = 0;
+  void *hnd = const_cast<native_handle_t *>(buffer);
+  if (!buffer || gralloc::GetMetaDataValue(hnd, (int64_t)StandardMetadataType::BUFFER_ID,
+                                           &buffer_id) != gralloc::Error::NONE) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(lock_);
+  auto it = entries_.find(buffer_id);
+  if (it == entries_.end()) {
+    return;
+  }
+
+  if (it->second.refs) {
+    // Still set on a layer, close once the last layer moves off it.
+    it->second.evicted = true;
+    return;
+  }
+
+  CloseLocked(it);
+}
+
+void HWCBufferFdRegistry::CloseLocked(std::unordered_map<uint64_t, Entry>::iterator it) {
+  if (!it->second.evicted) {
+    idle_.erase(it->second.idle_pos);
+  }
+  ::close(it->second.fd);
+  entries_.erase(it);
+}
+
 DisplayError SetCSC(const native_handle_t *handle, ColorMetaData *color_metadata) {
   void *hnd = const_cast<native_handle_t *>(handle);
 
@@ -361,7 +441,9 @@ HWCLayer::~HWCLayer() {
   // Close any fences left for this layer
   release_fence_ = nullptr;
   if (layer_) {
-    if (buffer_fd_ >= 0) {
+    if (registered_buffer_id_) {
+      HWCBufferFdRegistry::GetInstance()->Release(registered_buffer_id_);
+    } else if (buffer_fd_ >= 0) {
       ::close(buffer_fd_);
     }
     delete layer_;
@@ -441,15 +523,16 @@ HWC2::Error HWCLayer::SetLayerBuffer(buffer_handle_t buffer, shared_ptr<Fence> a
 
   layer_buffer->acquire_fence = acquire_fence;
 
-  int buffer_fd = buffer_fd_;
-  buffer_fd_ = ::dup(fd);
-  if (buffer_fd >= 0) {
-    ::close(buffer_fd);
+  uint64_t handle_id = 0;
+  auto err = gralloc::GetMetaDataValue(hnd, (int64_t)StandardMetadataType::BUFFER_ID, &handle_id);
+  if (err != gralloc::Error::NONE) {
+    DLOGW("Failed to retrieve buffer id");
   }
+  SetBufferFd(handle_id, fd);
 
   layer_buffer->planes[0].fd = buffer_fd_;
   layer_buffer->planes[0].offset = 0;
-  auto err =
+  err =
       gralloc::GetMetaDataValue(hnd, QTI_ALIGNED_WIDTH_IN_PIXELS, &layer_buffer->planes[0].stride);
   if (err != gralloc::Error::NONE) {
     DLOGW("Failed to retrieve aligned width");
@@ -462,13 +545,15 @@ HWC2::Error HWCLayer::SetLayerBuffer(buffer_handle_t buffer, shared_ptr<Fence> a
     DLOGW("Failed to retrieve allocation size");
   }
   buffer_flipped_ = reinterpret_cast<uint64_t>(handle) != layer_buffer->buffer_id;
+  if (buffer_flipped_) {
+    buffer_updated_ = true;
+    if (content_frame_rate_enabled_) {
+      cadence_.AddTimestamp(systemTime(SYSTEM_TIME_MONOTONIC));
+    }
+  }
   layer_buffer->buffer_id = reinterpret_cast<uint64_t>(handle);
+  layer_buffer->handle_id = handle_id;
   int64_t hd_id, hd_usage;
-  err = gralloc::GetMetaDataValue(hnd, (int64_t)StandardMetadataType::BUFFER_ID,
-                                  &layer_buffer->handle_id);
-  if (err != gralloc::Error::NONE) {
-    DLOGW("Failed to retrieve buffer id");
-  }
   err = gralloc::GetMetaDataValue(hnd, (int64_t)StandardMetadataType::USAGE, &layer_buffer->usage);
   if (err != gralloc::Error::NONE) {
     DLOGW("Failed to retrieve handle usage");
@@ -476,6 +561,53 @@ HWC2::Error HWCLayer::SetLayerBuffer(buffer_handle_t buffer, shared_ptr<Fence> a
   return HWC2::Error::None;
 }
 
+void HWCLayer::SetBufferFd(uint64_t handle_id, int fd) {
+  if (handle_id && handle_id == registered_buffer_id_) {
+    return;
+  }
+
+  int buffer_fd = buffer_fd_;
+  uint64_t buffer_id = registered_buffer_id_;
+  if (handle_id) {
+    buffer_fd_ = HWCBufferFdRegistry::GetInstance()->Acquire(handle_id, fd);
+    registered_buffer_id_ = (buffer_fd_ >= 0) ? handle_id : 0;
+  } else {
+    // No buffer id to share the fd on, keep a private dup for this layer.
+    buffer_fd_ = ::dup(fd);
+    registered_buffer_id_ = 0;
+  }
+
+  if (buffer_id) {
+    HWCBufferFdRegistry::GetInstance()->Release(buffer_id);
+  } else if (buffer_fd >= 0) {
+    ::close(buffer_fd);
+  }
+}
+
+void HWCLayer::UpdateContentFrameRate(uint32_t panel_refresh_rate, int64_t now_ns,
+                                      int64_t reprobe_ns) {
+  // A layer can not be measured faster than the panel refreshes. Once the panel runs at the rate
+  // voted for, the vote is kept as long as the layer updates at that rate. Flipping the panel
+  // back to its full rate just to measure again costs power and can show as judder, so that is
+  // only done once per reprobe period.
+  uint32_t frame_rate = cadence_.GetFrameRate();
+  if (frame_rate && (frame_rate < panel_refresh_rate)) {
+    content_vote_time_ns_ = now_ns;
+  } else if (frame_rate && (frame_rate == layer_->content_frame_rate)) {
+    if ((now_ns - content_vote_time_ns_) > reprobe_ns) {
+      cadence_.Reset();
+      frame_rate = 0;
+    }
+  } else {
+    frame_rate = 0;
+  }
+
+  if (frame_rate != layer_->content_frame_rate) {
+    layer_->content_frame_rate = frame_rate;
+    layer_->update_mask.set(kMetadataUpdate);
+  }
+}
+
 HWC2::Error HWCLayer::SetLayerSurfaceDamage(hwc_region_t damage) {
   surface_updated_ = true;
   if ((damage.numRects == 1) && (damage.rects[0].bottom == 0) && (damage.rects[0].right == 0)) {
@@ -486,21 +618,17 @@ HWC2::Error HWCLayer::SetLayerSurfaceDamage(hwc_region_t damage) {
     layer_->update_mask.set(kSurfaceInvalidate);
   }
 
+  std::vector<LayerRect> dirty_regions;
+  GetDirtyRegions(damage, &dirty_regions);
+
   // Check if there is an update in SurfaceDamage rects.
-  if (layer_->dirty_regions.size() != damage.numRects) {
+  if (layer_->dirty_regions.size() != dirty_regions.size()) {
     layer_->update_mask.set(kSurfaceInvalidate);
-  } else {
-    for (uint32_t j = 0; j < damage.numRects; j++) {
-      LayerRect damage_rect;
-      SetRect(damage.rects[j], &damage_rect);
-      if (damage_rect != layer_->dirty_regions.at(j)) {
-        layer_->update_mask.set(kSurfaceDamage);
-        break;
-      }
-    }
+  } else if (layer_->dirty_regions != dirty_regions) {
+    layer_->update_mask.set(kSurfaceDamage);
   }
 
-  SetDirtyRegions(damage);
+  layer_->dirty_regions = std::move(dirty_regions);
   return HWC2::Error::None;
 }
 
@@ -1344,12 +1472,21 @@ bool HWCLayer::IsScalingPresent() {
   return ((src_width != dst_width) || (dst_height != src_height));
 }
 
-void HWCLayer::SetDirtyRegions(hwc_region_t surface_damage) {
-  layer_->dirty_regions.clear();
+void HWCLayer::GetDirtyRegions(hwc_region_t surface_damage,
+                               std::vector<LayerRect> *dirty_regions) {
   for (uint32_t i = 0; i < surface_damage.numRects; i++) {
     LayerRect rect;
     SetRect(surface_damage.rects[i], &rect);
-    layer_->dirty_regions.push_back(rect);
+    dirty_regions->push_back(rect);
+  }
+
+  // Empty and single invalid regions carry full and no damage, keep those as is.
+  if (dirty_regions->size() > 1) {
+    std::vector<LayerRect> coalesced;
+    CoalesceRects(*dirty_regions, &coalesced);
+    if (!coalesced.empty()) {
+      *dirty_regions = std::move(coalesced);
+    }
   }
 }
 
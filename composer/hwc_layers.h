@@ -27,6 +27,7 @@
 #include <QtiGrallocDefs.h>
 #include <core/layer_stack.h>
 #include <core/layer_buffer.h>
+#include <utils/cadence.h>
 #include <utils/utils.h>
 #define HWC2_INCLUDE_STRINGIFICATION
 #define HWC2_USE_CPP11
@@ -36,8 +37,11 @@
 #include <android/hardware/graphics/composer/2.3/IComposerClient.h>
 #include <vendor/qti/hardware/display/composer/3.1/IQtiComposerClient.h>
 
+#include <list>
 #include <map>
+#include <mutex>
 #include <set>
+#include <unordered_map>
 
 #include "core/buffer_allocator.h"
 #include "hwc_buffer_allocator.h"
@@ -66,6 +70,35 @@ enum LayerTypes {
   kLayerBrowser = 3,
 };
 
+// Holds one duplicated fd per live gralloc buffer, keyed by gralloc buffer id, so that layers
+// cycling through the same swapchain buffers do not dup/close the fd on every frame. Layers take
+// a reference while the buffer is set on them. The fd is closed once the composer drops the
+// buffer from its slot cache and no layer references it, or when it ages out of the bounded set
+// of unreferenced entries.
+class HWCBufferFdRegistry {
+ public:
+  static HWCBufferFdRegistry *GetInstance();
+  int Acquire(uint64_t buffer_id, int fd);
+  void Release(uint64_t buffer_id);
+  void Evict(buffer_handle_t buffer);
+
+ private:
+  struct Entry {
+    int fd = -1;
+    uint32_t refs = 0;
+    bool evicted = false;
+    std::list<uint64_t>::iterator idle_pos;
+  };
+
+  static const size_t kMaxIdleEntries = 64;
+
+  void CloseLocked(std::unordered_map<uint64_t, Entry>::iterator it);
+
+  std::mutex lock_;
+  std::unordered_map<uint64_t, Entry> entries_;
+  std::list<uint64_t> idle_;  // Unreferenced entries, oldest first.
+};
+
 class HWCLayer {
  public:
   explicit HWCLayer(hwc2_display_t display_id, HWCBufferAllocator *buf_allocator);
@@ -120,10 +153,14 @@ class HWCLayer {
   void SetLayerAsMask();
   bool BufferLatched() { return buffer_flipped_; }
   void ResetBufferFlip() { buffer_flipped_ = false; }
+  bool IsBufferUpdated() { return buffer_updated_; }
+  void ResetBufferUpdate() { buffer_updated_ = false; }
   shared_ptr<Fence> GetReleaseFence();
   void SetReleaseFence(const shared_ptr<Fence> &release_fence);
   bool IsLayerCompatible() { return compatible_; }
   void IgnoreSdrHistogramMetadata(bool disable) { ignore_sdr_histogram_md_ = disable; }
+  void EnableContentFrameRate(bool enable) { content_frame_rate_enabled_ = enable; }
+  void UpdateContentFrameRate(uint32_t panel_refresh_rate, int64_t now_ns, int64_t reprobe_ns);
 
  private:
   Layer *layer_ = nullptr;
@@ -140,15 +177,20 @@ class HWCLayer {
   LayerRect dst_rect_ = {};
   bool single_buffer_ = false;
   int buffer_fd_ = -1;
+  uint64_t registered_buffer_id_ = 0;
   bool dataspace_supported_ = false;
   bool surface_updated_ = true;
   bool non_integral_source_crop_ = false;
   bool has_metadata_refresh_rate_ = false;
   bool color_transform_matrix_set_ = false;
   bool buffer_flipped_ = false;
+  bool buffer_updated_ = false;
   bool secure_ = false;
   bool compatible_ = false;
   bool ignore_sdr_histogram_md_ = false;
+  bool content_frame_rate_enabled_ = false;
+  CadenceEstimator cadence_;
+  int64_t content_vote_time_ns_ = 0;
 
   // Composition requested by client(SF) Original
   HWC2::Composition client_requested_orig_ = HWC2::Composition::Device;
@@ -165,7 +207,8 @@ class HWCLayer {
   DisplayError SetMetaData(const native_handle_t *pvt_handle, Layer *layer);
   uint32_t RoundToStandardFPS(float fps);
   void ValidateAndSetCSC(const native_handle_t *handle);
-  void SetDirtyRegions(hwc_region_t surface_damage);
+  void SetBufferFd(uint64_t handle_id, int fd);
+  void GetDirtyRegions(hwc_region_t surface_damage, std::vector<LayerRect> *dirty_regions);
 };
 
 struct SortLayersByZ {
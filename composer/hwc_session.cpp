@@ -320,22 +320,47 @@ int HWCSession::Init() {
   async_vds_creation_ = (value == 1);
   DLOGI("async_vds_creation: %d", async_vds_creation_);
 
+  value = 0;
+  Debug::Get()->GetProperty(ENABLE_PARALLEL_VALIDATE_PROP, &value);
+  parallel_validate_ = (value == 1);
+  DLOGI("parallel_validate: %d", parallel_validate_);
+
+  value = 0;
+  Debug::Get()->GetProperty(ENABLE_PARALLEL_DISPLAY_INIT_PROP, &value);
+  parallel_display_init_ = (value == 1);
+  DLOGI("parallel_display_init: %d", parallel_display_init_);
+
   DLOGI("Initializing supported display slots");
   InitSupportedDisplaySlots();
   DLOGI("Initializing supported display slots...done!");
 
+  // Loading the color manager libraries does not depend on any display, overlap it with the
+  // creation of the primary display.
+  std::future<HWCColorManager *> color_mgr_loader = std::async(std::launch::async, [this]() {
+    return HWCColorManager::CreateColorManager(&buffer_allocator_);
+  });
+
   // Create primary display here. Remaining builtin displays will be created after client has set
   // display indexes which may happen sometime before callback is registered.
   DLOGI("Creating the Primary display");
   status = CreatePrimaryDisplay();
+  HWCColorManager *color_mgr = color_mgr_loader.get();
   if (status) {
     DLOGE("Creating the Primary display...failed!");
+    if (color_mgr) {
+      color_mgr->DestroyColorManager();
+    }
     Deinit();
     return status;
   } else {
     DLOGI("Creating the Primary display...done!");
   }
 
+  color_mgr_ = color_mgr;
+  if (!color_mgr_) {
+    DLOGW("Failed to load HWCColorManager.");
+  }
+
   is_composer_up_ = true;
   StartServices();
 
@@ -899,6 +924,8 @@ void HWCSession::PostCommitLocked(hwc2_display_t display, shared_ptr<Fence> &ret
 
 void HWCSession::PostCommitUnlocked(hwc2_display_t display,
                                     const shared_ptr<Fence> &retire_fence) {
+  // Serialize session wide bookkeeping when displays are validated in parallel.
+  std::lock_guard<std::mutex> post_commit_lock(post_commit_lock_);
   HandlePendingPowerMode(display, retire_fence);
   HandlePendingHotplug(display, retire_fence);
   HandlePendingRefresh();
@@ -2902,10 +2929,6 @@ int HWCSession::CreatePrimaryDisplay() {
 
         map_info_primary_.disp_type = info.display_type;
         map_info_primary_.sdm_id = info.display_id;
-        color_mgr_ = HWCColorManager::CreateColorManager(&buffer_allocator_);
-        if (!color_mgr_) {
-          DLOGW("Failed to load HWCColorManager.");
-        }
 
         map_active_displays_.insert(std::make_pair(client_id, info.display_type));
       } else {
@@ -2944,7 +2967,15 @@ int HWCSession::HandleBuiltInDisplays() {
     return -EINVAL;
   }
 
-  int status = 0;
+  // Pair each builtin display with a free client slot first. SDM reserves the hardware of each
+  // display under its core lock, the remaining per display setup such as color mode loading is
+  // independent and, if enabled, runs concurrently across the displays.
+  struct PendingBuiltIn {
+    DisplayMapInfo *map_info;
+    int32_t sdm_id;
+    std::future<int> status;
+  };
+  std::vector<PendingBuiltIn> pending_displays = {};
   for (auto &iter : hw_displays_info) {
     auto &info = iter.second;
 
@@ -2955,45 +2986,69 @@ int HWCSession::HandleBuiltInDisplays() {
 
     for (auto &map_info : map_info_builtin_) {
       hwc2_display_t client_id = map_info.client_id;
-
+      bool slot_taken = std::any_of(pending_displays.begin(), pending_displays.end(),
+                                    [&map_info](auto &pending) {
+                                      return pending.map_info == &map_info;
+                                    });
       {
         SCOPE_LOCK(locker_[client_id]);
-        // Lock confined to this scope
-        if (hwc_display_[client_id]) {
+        if (hwc_display_[client_id] || slot_taken) {
           continue;
         }
+      }
 
-        DLOGI("Create builtin display, sdm id = %d, client id = %d", info.display_id,
-              UINT32(client_id));
-        status = HWCDisplayBuiltIn::Create(core_intf_, &buffer_allocator_, &callbacks_, this,
-                                           qservice_, client_id, info.display_id,
-                                           &hwc_display_[client_id]);
-        if (status) {
-          DLOGE("Builtin display creation failed.");
-          break;
-        }
+      DLOGI("Create builtin display, sdm id = %d, client id = %d", info.display_id,
+            UINT32(client_id));
+      int32_t sdm_id = info.display_id;
+      auto create = [this, client_id, sdm_id]() {
+        SCOPE_LOCK(locker_[client_id]);
+        return HWCDisplayBuiltIn::Create(core_intf_, &buffer_allocator_, &callbacks_, this,
+                                         qservice_, client_id, sdm_id, &hwc_display_[client_id]);
+      };
+      auto policy = parallel_display_init_ ? std::launch::async : std::launch::deferred;
+      pending_displays.push_back({&map_info, sdm_id, std::async(policy, create)});
+      break;
+    }
+  }
 
-        {
-          SCOPE_LOCK(hdr_locker_[client_id]);
-          is_hdr_display_[UINT32(client_id)] = HasHDRSupport(hwc_display_[client_id]);
-        }
+  // Wait for all of them before any hotplug, so that creation failures are handled as before.
+  std::vector<int> create_status = {};
+  for (auto &pending : pending_displays) {
+    create_status.push_back(pending.status.get());
+  }
 
-        DLOGI("Builtin display created: sdm id = %d, client id = %d", info.display_id,
-              UINT32(client_id));
-        map_info.disp_type = info.display_type;
-        map_info.sdm_id = info.display_id;
+  int status = 0;
+  for (size_t i = 0; i < pending_displays.size(); i++) {
+    DisplayMapInfo &map_info = *pending_displays[i].map_info;
+    hwc2_display_t client_id = map_info.client_id;
+    int32_t sdm_id = pending_displays[i].sdm_id;
 
-        map_active_displays_.insert(std::make_pair(client_id, info.display_type));
+    if (create_status[i]) {
+      DLOGE("Builtin display creation failed. sdm id = %d, client id = %d", sdm_id,
+            UINT32(client_id));
+      status = create_status[i];
+      continue;
+    }
+
+    {
+      SCOPE_LOCK(locker_[client_id]);
+      {
+        SCOPE_LOCK(hdr_locker_[client_id]);
+        is_hdr_display_[UINT32(client_id)] = HasHDRSupport(hwc_display_[client_id]);
       }
 
-      DLOGI("Hotplugging builtin display, sdm id = %d, client id = %d", info.display_id,
-            UINT32(client_id));
-      // Free lock before the callback
-      primary_display_lock_.Unlock();
-      callbacks_.Hotplug(client_id, HWC2::Connection::Connected);
-      primary_display_lock_.Lock();
-      break;
+      DLOGI("Builtin display created: sdm id = %d, client id = %d", sdm_id, UINT32(client_id));
+      map_info.disp_type = kBuiltIn;
+      map_info.sdm_id = sdm_id;
+
+      map_active_displays_.insert(std::make_pair(client_id, kBuiltIn));
     }
+
+    DLOGI("Hotplugging builtin display, sdm id = %d, client id = %d", sdm_id, UINT32(client_id));
+    // Free lock before the callback
+    primary_display_lock_.Unlock();
+    callbacks_.Hotplug(client_id, HWC2::Connection::Connected);
+    primary_display_lock_.Lock();
   }
 
   return status;
@@ -3459,6 +3514,7 @@ void HWCSession::VmReleaseDone(hwc2_display_t display) {
 }
 
 void HWCSession::HandleSecureSession() {
+  std::lock_guard<std::mutex> secure_session_lock(secure_session_lock_);
   std::bitset<kSecureMax> secure_sessions = 0;
   hwc2_display_t client_id = HWCCallbacks::kNumDisplays;
   {
@@ -3645,25 +3701,48 @@ void HWCSession::HandlePendingHotplug(hwc2_display_t disp_id,
     return;
   }
 
-  if (kHotPlugEvent == pending_hotplug_event_) {
-    Fence::Wait(retire_fence);
+  // Handle connect/disconnect hotplugs if secure session is not present.
+  hwc2_display_t virtual_display_idx = (hwc2_display_t)GetDisplayIndex(qdutils::DISPLAY_VIRTUAL);
+  if (kHotPlugEvent != pending_hotplug_event_ || hwc_display_[virtual_display_idx]) {
+    return;
+  }
 
-    // Handle connect/disconnect hotplugs if secure session is not present.
-    hwc2_display_t virtual_display_idx = (hwc2_display_t)GetDisplayIndex(qdutils::DISPLAY_VIRTUAL);
-    if (!hwc_display_[virtual_display_idx] && kHotPlugEvent == pending_hotplug_event_) {
-      // Handle deferred hotplug event.
-      int32_t err = pluggable_handler_lock_.TryLock();
-      if (!err) {
-        // Do hotplug handling in a different thread to avoid blocking PresentDisplay.
-        std::thread(&HWCSession::HandlePluggableDisplays, this, true).detach();
-        pluggable_handler_lock_.Unlock();
-      } else {
-        // EBUSY means another thread is already handling hotplug. Skip deferred hotplug handling.
-        if (EBUSY != err) {
-          DLOGW("Failed to acquire pluggable display handler lock. Error %d '%s'.", err,
-                strerror(abs(err)));
-        }
-      }
+  // Hotplug handling must start only after this commit is retired. Let the fence watcher report
+  // the retire instead of blocking PresentDisplay on it, one wait at a time.
+  if (deferred_hotplug_queued_.exchange(true)) {
+    return;
+  }
+
+  int err = Fence::WaitAsync(retire_fence, kDeferredHotplugTimeoutMs, [this](int status) {
+    deferred_hotplug_queued_ = false;
+    if (status) {
+      DLOGW("Retire fence wait for deferred hotplug failed. Error %d", status);
+    }
+    HandleDeferredHotplug();
+  });
+  if (err) {
+    deferred_hotplug_queued_ = false;
+    DLOGW("Failed to watch retire fence. Error %d, handling hotplug now", err);
+    HandleDeferredHotplug();
+  }
+}
+
+void HWCSession::HandleDeferredHotplug() {
+  if (kHotPlugEvent != pending_hotplug_event_) {
+    return;
+  }
+
+  // Handle deferred hotplug event.
+  int32_t err = pluggable_handler_lock_.TryLock();
+  if (!err) {
+    // Do hotplug handling in a different thread to avoid blocking PresentDisplay.
+    std::thread(&HWCSession::HandlePluggableDisplays, this, true).detach();
+    pluggable_handler_lock_.Unlock();
+  } else {
+    // EBUSY means another thread is already handling hotplug. Skip deferred hotplug handling.
+    if (EBUSY != err) {
+      DLOGW("Failed to acquire pluggable display handler lock. Error %d '%s'.", err,
+            strerror(abs(err)));
     }
   }
 }
@@ -4524,6 +4603,89 @@ HWC2::Error HWCSession::CommitOrPrepare(hwc2_display_t display, bool validate_on
   return status;
 }
 
+void HWCSession::ValidateDisplays(const std::vector<hwc2_display_t> &displays,
+                                  std::vector<ValidateResult> *results) {
+  DTRACE_SCOPED();
+  auto validate = [this](hwc2_display_t display) {
+    ValidateResult result = {};
+    shared_ptr<Fence> retire_fence = nullptr;
+    bool needs_commit = false;
+    result.status = CommitOrPrepare(display, true /* validate_only */, &retire_fence,
+                                    &result.num_types, &result.num_requests, &needs_commit);
+    return result;
+  };
+
+  results->clear();
+  results->resize(displays.size());
+  if (displays.empty()) {
+    return;
+  }
+
+  // Composition selection stays serialized in CompManager, the rest of the prepare and the
+  // TEST_ONLY commit of each display are independent. Hand all but the last display to their
+  // workers, validate the last one on the calling thread and join, so that the batch costs about
+  // as much as the slowest display rather than the sum of all of them.
+  std::vector<ValidateWorker *> workers;
+  for (size_t i = 0; i + 1 < displays.size(); i++) {
+    hwc2_display_t display = displays[i];
+    if (display >= HWCCallbacks::kNumDisplays) {
+      results->at(i) = validate(display);
+      continue;
+    }
+    if (!validate_workers_[display]) {
+      validate_workers_[display] = std::make_unique<ValidateWorker>();
+    }
+    ValidateWorker *worker = validate_workers_[display].get();
+    worker->Post([&validate, results, display, i]() { results->at(i) = validate(display); });
+    workers.push_back(worker);
+  }
+  results->back() = validate(displays.back());
+  for (auto worker : workers) {
+    worker->Wait();
+  }
+}
+
+HWCSession::ValidateWorker::ValidateWorker() : thread_(&ValidateWorker::Run, this) {}
+
+HWCSession::ValidateWorker::~ValidateWorker() {
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    exit_ = true;
+    cv_.notify_all();
+  }
+  thread_.join();
+}
+
+void HWCSession::ValidateWorker::Post(std::function<void()> job) {
+  std::lock_guard<std::mutex> lock(lock_);
+  job_ = std::move(job);
+  busy_ = true;
+  cv_.notify_all();
+}
+
+void HWCSession::ValidateWorker::Wait() {
+  std::unique_lock<std::mutex> lock(lock_);
+  cv_.wait(lock, [this] { return !busy_; });
+}
+
+void HWCSession::ValidateWorker::Run() {
+  std::unique_lock<std::mutex> lock(lock_);
+  while (true) {
+    cv_.wait(lock, [this] { return exit_ || job_; });
+    if (exit_) {
+      return;
+    }
+
+    auto job = std::move(job_);
+    job_ = nullptr;
+    lock.unlock();
+    job();
+    lock.lock();
+    busy_ = false;
+    cv_.notify_all();
+  }
+}
+
 HWC2::Error HWCSession::TryDrawMethod(hwc2_display_t display,
                                       IQtiComposerClient::DrawMethod drawMethod) {
   Locker::ScopeLock lock_d(locker_[display]);
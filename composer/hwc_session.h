@@ -42,6 +42,7 @@
 #include <queue>
 #include <utility>
 #include <future>   // NOLINT
+#include <thread>
 #include <map>
 #include <unordered_map>
 #include <string>
@@ -341,6 +342,15 @@ class HWCSession : hwc2_device_t, HWCUEventListener, public qClient::BnQClient,
                               bool *needs_commit);
   HWC2::Error TryDrawMethod(hwc2_display_t display, IQtiComposerClient::DrawMethod drawMethod);
 
+  struct ValidateResult {
+    HWC2::Error status = HWC2::Error::None;
+    uint32_t num_types = 0;
+    uint32_t num_requests = 0;
+  };
+  bool IsParallelValidateEnabled() { return parallel_validate_; }
+  void ValidateDisplays(const std::vector<hwc2_display_t> &displays,
+                        std::vector<ValidateResult> *results);
+
 
   static Locker locker_[HWCCallbacks::kNumDisplays];
   static Locker hdr_locker_[HWCCallbacks::kNumDisplays];
@@ -353,6 +363,26 @@ class HWCSession : hwc2_device_t, HWCUEventListener, public qClient::BnQClient,
   static std::bitset<HWCCallbacks::kNumDisplays> clients_waiting_for_vm_release_;
 
  private:
+  // Persistent worker thread of a display, runs its share of the validates fanned out by
+  // ValidateDisplays() without spawning a thread per validate.
+  class ValidateWorker {
+   public:
+    ValidateWorker();
+    ~ValidateWorker();
+    void Post(std::function<void()> job);
+    void Wait();
+
+   private:
+    void Run();
+
+    std::mutex lock_;
+    std::condition_variable cv_;
+    std::function<void()> job_ = nullptr;
+    bool busy_ = false;
+    bool exit_ = false;
+    std::thread thread_;  // Started last, once the state above is constructed.
+  };
+
   class CWB {
    public:
     explicit CWB(HWCSession *hwc_session) : hwc_session_(hwc_session) { }
@@ -488,6 +518,7 @@ class HWCSession : hwc2_device_t, HWCUEventListener, public qClient::BnQClient,
   static const int kVmReleaseRetry = 3;
   static const int kDenomNstoMs = 1000000;
   static const int kNumDrawCycles = 3;
+  static const int kDeferredHotplugTimeoutMs = 1000;
 
   uint32_t throttling_refresh_rate_ = 60;
   std::mutex hotplug_mutex_;
@@ -590,6 +621,7 @@ class HWCSession : hwc2_device_t, HWCUEventListener, public qClient::BnQClient,
   void HandleSecureSession();
   void HandlePendingPowerMode(hwc2_display_t display, const shared_ptr<Fence> &retire_fence);
   void HandlePendingHotplug(hwc2_display_t disp_id, const shared_ptr<Fence> &retire_fence);
+  void HandleDeferredHotplug();
   bool IsPluggableDisplayConnected();
   bool IsVirtualDisplayConnected();
   hwc2_display_t GetActiveBuiltinDisplay();
@@ -642,6 +674,7 @@ class HWCSession : hwc2_device_t, HWCUEventListener, public qClient::BnQClient,
   std::mutex mutex_lum_;
   static bool pending_power_mode_[HWCCallbacks::kNumDisplays];
   HotPlugEvent pending_hotplug_event_ = kHotPlugNone;
+  std::atomic<bool> deferred_hotplug_queued_ = false;
 
   struct VirtualDisplayData {
     uint32_t width;
@@ -666,6 +699,11 @@ class HWCSession : hwc2_device_t, HWCUEventListener, public qClient::BnQClient,
   std::unordered_map<int64_t, std::shared_ptr<IDisplayConfigCallback>> callback_clients_;
   uint64_t callback_client_id_ = 0;
   bool async_vds_creation_ = false;
+  bool parallel_validate_ = false;
+  std::unique_ptr<ValidateWorker> validate_workers_[HWCCallbacks::kNumDisplays];
+  bool parallel_display_init_ = false;
+  std::mutex secure_session_lock_;
+  std::mutex post_commit_lock_;
   std::bitset<HWCCallbacks::kNumDisplays> display_ready_;
   bool secure_session_active_ = false;
   bool tui_start_success_ = false;
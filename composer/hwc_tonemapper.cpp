@@ -40,6 +40,9 @@
 #include <utils/rect.h>
 #include <utils/utils.h>
 
+#include <algorithm>
+#include <functional>
+#include <string_view>
 #include <vector>
 
 #include "hwc_debugger.h"
@@ -49,14 +52,137 @@
 
 namespace sdm {
 
+ToneMapConfig::ToneMapConfig(const Layer *layer, PrimariesTransfer layer_blend_cs) {
+  // HDR -> SDR is FORWARD and SDR - > HDR is INVERSE
+  type = layer->input_buffer.flags.hdr ? TONEMAP_FORWARD : TONEMAP_INVERSE;
+  blend_cs = layer_blend_cs;
+  transfer = layer->input_buffer.color_metadata.transfer;
+  secure = layer->request.flags.secure;
+  format = layer->request.format;
+  width = layer->request.width;
+  height = layer->request.height;
+
+  // Sessions bake the LUT into the GL tonemapper when they are created, so a session can only be
+  // reused for content that generated the same LUT.
+  const Lut3d &lut_3d = layer->lut_3d;
+  auto hash_entries = [this](const void *entries, size_t size) {
+    size_t value = std::hash<std::string_view>()(
+        std::string_view(reinterpret_cast<const char *>(entries), size));
+    lut_hash ^= value + 0x9e3779b9 + (lut_hash << 6) + (lut_hash >> 2);
+  };
+
+  if (lut_3d.lutEntries) {
+    hash_entries(lut_3d.lutEntries,
+                 size_t(lut_3d.dim) * lut_3d.dim * lut_3d.dim * sizeof(*lut_3d.lutEntries));
+  }
+  if (lut_3d.validGridEntries && lut_3d.gridEntries) {
+    hash_entries(lut_3d.gridEntries, size_t(lut_3d.gridSize) * sizeof(*lut_3d.gridEntries));
+  }
+}
+
+size_t ToneMapConfig::Hash() const {
+  size_t hash = 0;
+  auto combine = [&hash](size_t value) {
+    hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  };
+
+  combine(std::hash<int>()(type));
+  combine(std::hash<int>()(INT(blend_cs.primaries)));
+  combine(std::hash<int>()(INT(blend_cs.transfer)));
+  combine(std::hash<int>()(INT(transfer)));
+  combine(std::hash<int>()(INT(format)));
+  combine(std::hash<bool>()(secure));
+  combine(std::hash<uint32_t>()(width));
+  combine(std::hash<uint32_t>()(height));
+  combine(lut_hash);
+
+  return hash;
+}
+
+bool ToneMapConfig::operator==(const ToneMapConfig &config) const {
+  return ((type == config.type) && (blend_cs == config.blend_cs) &&
+          (transfer == config.transfer) && (format == config.format) &&
+          (secure == config.secure) && (width == config.width) && (height == config.height) &&
+          (lut_hash == config.lut_hash));
+}
+
+ToneMapBufferPool *ToneMapBufferPool::GetInstance() {
+  static ToneMapBufferPool buffer_pool;
+  return &buffer_pool;
+}
+
+uint64_t ToneMapBufferPool::GetBufferClass(const BufferConfig &config) {
+  // width:24 | height:24 | format:15 | secure:1
+  return ((UINT64(config.width) & 0xFFFFFF) << 40) | ((UINT64(config.height) & 0xFFFFFF) << 16) |
+         ((UINT64(config.format) & 0x7FFF) << 1) | (config.secure ? 1 : 0);
+}
+
+bool ToneMapBufferPool::Acquire(const BufferConfig &config, BufferInfo *buffer_info,
+                                shared_ptr<Fence> *release_fence) {
+  std::lock_guard<std::mutex> lock(lock_);
+  auto it = free_buffers_.find(GetBufferClass(config));
+  if (it == free_buffers_.end() || it->second.empty()) {
+    misses_++;
+    return false;
+  }
+
+  // The buffer may still be on screen, hand over its release fence to the new owner.
+  PooledBuffer &pooled_buffer = it->second.back();
+  *buffer_info = pooled_buffer.buffer_info;
+  *release_fence = pooled_buffer.release_fence;
+  it->second.pop_back();
+  pooled_count_--;
+  hits_++;
+
+  return true;
+}
+
+void ToneMapBufferPool::Release(HWCBufferAllocator *buffer_allocator, BufferInfo *buffer_info,
+                                const shared_ptr<Fence> &release_fence) {
+  std::lock_guard<std::mutex> lock(lock_);
+  if (pooled_count_ >= kMaxPooledBuffers) {
+    buffer_allocator->FreeBuffer(buffer_info);
+    return;
+  }
+
+  PooledBuffer pooled_buffer;
+  pooled_buffer.buffer_info = *buffer_info;
+  pooled_buffer.release_fence = release_fence;
+  pooled_buffer.buffer_allocator = buffer_allocator;
+  free_buffers_[GetBufferClass(buffer_info->buffer_config)].push_back(pooled_buffer);
+  pooled_count_++;
+
+  *buffer_info = BufferInfo();
+}
+
+void ToneMapBufferPool::Trim() {
+  std::lock_guard<std::mutex> lock(lock_);
+  for (auto &buffer_class : free_buffers_) {
+    for (auto &pooled_buffer : buffer_class.second) {
+      pooled_buffer.buffer_allocator->FreeBuffer(&pooled_buffer.buffer_info);
+    }
+  }
+  free_buffers_.clear();
+  pooled_count_ = 0;
+}
+
+void ToneMapBufferPool::Dump(std::ostringstream *os) {
+  std::lock_guard<std::mutex> lock(lock_);
+  uint64_t lookups = hits_ + misses_;
+  *os << "buffer pool: pooled " << pooled_count_ << "/" << kMaxPooledBuffers;
+  *os << " hits " << hits_ << " misses " << misses_;
+  *os << " hit rate " << (lookups ? (hits_ * 100 / lookups) : 0) << "%" << std::endl;
+}
+
 ToneMapSession::ToneMapSession(HWCBufferAllocator *buffer_allocator)
   : tone_map_task_(*this), buffer_allocator_(buffer_allocator) {
   buffer_info_.resize(kNumIntermediateBuffers);
 }
 
 ToneMapSession::~ToneMapSession() {
-  tone_map_task_.PerformTask(ToneMapTaskCode::kCodeDestroy, nullptr);
+  // Evict the cached EGLImages of the intermediate buffers while the GL tonemapper still exists.
   FreeIntermediateBuffers();
+  tone_map_task_.PerformTask(ToneMapTaskCode::kCodeDestroy, nullptr);
   buffer_info_.clear();
 }
 
@@ -92,8 +218,17 @@ void ToneMapSession::OnTask(const ToneMapTaskCode &task_code,
       }
       break;
 
+    case ToneMapTaskCode::kCodeEvict: {
+        ToneMapEvictContext *ctx = static_cast<ToneMapEvictContext *>(task_context);
+        if (gpu_tone_mapper_) {
+          gpu_tone_mapper_->evict(ctx->handle);
+        }
+      }
+      break;
+
     case ToneMapTaskCode::kCodeDestroy: {
         delete gpu_tone_mapper_;
+        gpu_tone_mapper_ = nullptr;
       }
       break;
 
@@ -104,6 +239,7 @@ void ToneMapSession::OnTask(const ToneMapTaskCode &task_code,
 }
 
 DisplayError ToneMapSession::AllocateIntermediateBuffers(const Layer *layer) {
+  ToneMapBufferPool *buffer_pool = ToneMapBufferPool::GetInstance();
   for (uint8_t i = 0; i < kNumIntermediateBuffers; i++) {
     BufferInfo &buffer_info = buffer_info_[i];
     buffer_info.buffer_config.width = layer->request.width;
@@ -111,6 +247,10 @@ DisplayError ToneMapSession::AllocateIntermediateBuffers(const Layer *layer) {
     buffer_info.buffer_config.format = layer->request.format;
     buffer_info.buffer_config.secure = layer->request.flags.secure;
     buffer_info.buffer_config.gfx_client = true;
+    if (buffer_pool->Acquire(buffer_info.buffer_config, &buffer_info, &release_fence_[i])) {
+      continue;
+    }
+
     int err = buffer_allocator_->AllocateBuffer(&buffer_info);
     if (err != 0) {
       FreeIntermediateBuffers();
@@ -125,7 +265,16 @@ void ToneMapSession::FreeIntermediateBuffers() {
   for (uint8_t i = 0; i < kNumIntermediateBuffers; i++) {
     BufferInfo &buffer_info = buffer_info_[i];
     if (buffer_info.private_data) {
-      buffer_allocator_->FreeBuffer(&buffer_info);
+      // Drop the EGLImage cached for the buffer along with the buffer itself.
+      if (gpu_tone_mapper_) {
+        ToneMapEvictContext ctx;
+        ctx.handle = buffer_info.private_data;
+        tone_map_task_.PerformTask(ToneMapTaskCode::kCodeEvict, &ctx);
+      }
+      // Recycle the buffer through the shared pool, along with its pending release fence.
+      ToneMapBufferPool::GetInstance()->Release(buffer_allocator_, &buffer_info,
+                                                release_fence_[i]);
+      release_fence_[i] = nullptr;
     }
   }
 }
@@ -143,32 +292,13 @@ void ToneMapSession::SetReleaseFence(const shared_ptr<Fence> &fd) {
   release_fence_[current_buffer_index_] = fd;
 }
 
-void ToneMapSession::SetToneMapConfig(Layer *layer, PrimariesTransfer blend_cs) {
-  // HDR -> SDR is FORWARD and SDR - > HDR is INVERSE
-  tone_map_config_.type = layer->input_buffer.flags.hdr ? TONEMAP_FORWARD : TONEMAP_INVERSE;
-  tone_map_config_.blend_cs = blend_cs;
-  tone_map_config_.transfer = layer->input_buffer.color_metadata.transfer;
-  tone_map_config_.secure = layer->request.flags.secure;
-  tone_map_config_.format = layer->request.format;
-}
-
-bool ToneMapSession::IsSameToneMapConfig(Layer *layer, PrimariesTransfer blend_cs) {
-  LayerBuffer& buffer = layer->input_buffer;
-  native_handle_t *handle = static_cast<native_handle_t *>(buffer_info_[0].private_data);
-  int tonemap_type = buffer.flags.hdr ? TONEMAP_FORWARD : TONEMAP_INVERSE;
-
-  uint32_t handle_unaligned_width, handle_unaligned_height = 0;
-  buffer_allocator_->GetUnalignedWidth(handle, handle_unaligned_width);
-  buffer_allocator_->GetUnalignedHeight(handle, handle_unaligned_height);
-  return ((tonemap_type == tone_map_config_.type) && (blend_cs == tone_map_config_.blend_cs) &&
-          (buffer.color_metadata.transfer == tone_map_config_.transfer) &&
-          (layer->request.flags.secure == tone_map_config_.secure) &&
-          (layer->request.format == tone_map_config_.format) &&
-          (layer->request.width == handle_unaligned_width) &&
-          (layer->request.height == handle_unaligned_height));
+void ToneMapSession::SetToneMapConfig(const ToneMapConfig &config) {
+  tone_map_config_ = config;
+  tone_map_config_hash_ = config.Hash();
 }
 
 int HWCToneMapper::HandleToneMap(LayerStack *layer_stack) {
+  std::lock_guard<std::mutex> lock(lock_);
   uint32_t gpu_count = 0;
   DisplayError error = kErrorNone;
 
@@ -205,7 +335,7 @@ int HWCToneMapper::HandleToneMap(LayerStack *layer_stack) {
       }
 
       if (error != kErrorNone) {
-        Terminate();
+        TerminateLocked();
         return -1;
       }
 
@@ -239,6 +369,7 @@ void HWCToneMapper::ToneMap(Layer* layer, ToneMapSession *session) {
 }
 
 void HWCToneMapper::PostCommit(LayerStack *layer_stack) {
+  std::lock_guard<std::mutex> lock(lock_);
   auto it = tone_map_sessions_.begin();
   while (it != tone_map_sessions_.end()) {
     uint32_t session_index = UINT32(std::distance(tone_map_sessions_.begin(), it));
@@ -251,9 +382,9 @@ void HWCToneMapper::PostCommit(LayerStack *layer_stack) {
       session->acquired_ = false;
       it++;
     } else {
-      DLOGI_IF(kTagClient, "Tone map session %d closed.", session_index);
-      delete session;
+      DLOGI_IF(kTagClient, "Tone map session %d idle.", session_index);
       it = tone_map_sessions_.erase(it);
+      RetainSession(session);
       int deleted_session = INT(session_index);
       // If FB tonemap session gets deleted, reset fb_session_index_, else update it.
       if (deleted_session == fb_session_index_) {
@@ -263,18 +394,109 @@ void HWCToneMapper::PostCommit(LayerStack *layer_stack) {
       }
     }
   }
+
+  AgeIdleSessions();
+}
+
+void HWCToneMapper::RetainSession(ToneMapSession *session) {
+  session->acquired_ = false;
+  session->idle_frame_count_ = 0;
+  idle_sessions_.push_front(session);
+
+  if (idle_sessions_.size() > kMaxIdleSessions) {
+    ToneMapSession *lru_session = idle_sessions_.back();
+    idle_sessions_.pop_back();
+    DestroySession(lru_session);
+    session_evictions_++;
+  }
+}
+
+void HWCToneMapper::DestroySession(ToneMapSession *session) {
+  auto range = session_map_.equal_range(session->tone_map_config_hash_);
+  for (auto it = range.first; it != range.second; it++) {
+    if (it->second == session) {
+      session_map_.erase(it);
+      break;
+    }
+  }
+
+  delete session;
+}
+
+void HWCToneMapper::AgeIdleSessions() {
+  auto it = idle_sessions_.begin();
+  while (it != idle_sessions_.end()) {
+    ToneMapSession *session = *it;
+    if (++session->idle_frame_count_ > kMaxIdleFrames) {
+      DLOGI_IF(kTagClient, "Tone map session %p closed.", session);
+      it = idle_sessions_.erase(it);
+      DestroySession(session);
+    } else {
+      it++;
+    }
+  }
+}
+
+void HWCToneMapper::Release() {
+  std::lock_guard<std::mutex> lock(lock_);
+  // No layer needs tone mapping in this frame, keep the sessions around for a while in case the
+  // content switches back.
+  while (!tone_map_sessions_.empty()) {
+    ToneMapSession *session = tone_map_sessions_.back();
+    tone_map_sessions_.pop_back();
+    RetainSession(session);
+  }
+  fb_session_index_ = -1;
+
+  AgeIdleSessions();
+}
+
+void HWCToneMapper::TrimIdleSessions() {
+  std::lock_guard<std::mutex> lock(lock_);
+  // The display stopped committing, so idle sessions would not age out until it resumes. Drop
+  // them along with the pooled buffers; sessions on screen stay.
+  if (idle_sessions_.empty()) {
+    return;
+  }
+
+  while (!idle_sessions_.empty()) {
+    DestroySession(idle_sessions_.back());
+    idle_sessions_.pop_back();
+  }
+  ToneMapBufferPool::GetInstance()->Trim();
 }
 
 void HWCToneMapper::Terminate() {
-  if (tone_map_sessions_.size()) {
+  std::lock_guard<std::mutex> lock(lock_);
+  TerminateLocked();
+}
+
+void HWCToneMapper::TerminateLocked() {
+  if (tone_map_sessions_.size() || idle_sessions_.size()) {
     while (!tone_map_sessions_.empty()) {
-      delete tone_map_sessions_.back();
+      DestroySession(tone_map_sessions_.back());
       tone_map_sessions_.pop_back();
     }
+    while (!idle_sessions_.empty()) {
+      DestroySession(idle_sessions_.back());
+      idle_sessions_.pop_back();
+    }
     fb_session_index_ = -1;
+    ToneMapBufferPool::GetInstance()->Trim();
   }
 }
 
+void HWCToneMapper::Dump(std::ostringstream *os) {
+  std::lock_guard<std::mutex> lock(lock_);
+  uint64_t lookups = session_hits_ + session_misses_;
+  *os << "\n----------Tone Mapper----------\n";
+  *os << "sessions: active " << tone_map_sessions_.size() << " idle " << idle_sessions_.size();
+  *os << " hits " << session_hits_ << " misses " << session_misses_;
+  *os << " evictions " << session_evictions_;
+  *os << " hit rate " << (lookups ? (session_hits_ * 100 / lookups) : 0) << "%" << std::endl;
+  ToneMapBufferPool::GetInstance()->Dump(os);
+}
+
 void HWCToneMapper::SetFrameDumpConfig(uint32_t count) {
   DLOGI("Dump FrameConfig count = %d", count);
   dump_frame_count_ = count;
@@ -300,10 +522,9 @@ void HWCToneMapper::DumpToneMapOutput(ToneMapSession *session, shared_ptr<Fence>
 
   size_t result = 0;
   char dump_file_name[PATH_MAX];
-  uint32_t width, height, size = 0;
-  buffer_allocator_->GetWidth((void *)target_buffer, width);
-  buffer_allocator_->GetHeight((void *)target_buffer, height);
-  buffer_allocator_->GetAllocationSize((void *)target_buffer, size);
+  BufferDescriptorInfo info;
+  buffer_allocator_->GetBufferDescriptor((void *)target_buffer, &info);
+  uint32_t width = info.width, height = info.height, size = info.alloc_size;
 
   snprintf(dump_file_name, sizeof(dump_file_name),
            "%s/frame_dump_primary"
@@ -334,24 +555,40 @@ DisplayError HWCToneMapper::AcquireToneMapSession(Layer *layer, uint32_t *sessio
     return kErrorParameters;
   }
 
-  // Check if we can re-use an existing tone map session.
-  for (uint32_t i = 0; i < tone_map_sessions_.size(); i++) {
-    ToneMapSession *tonemap_session = tone_map_sessions_.at(i);
-    if (!tonemap_session->acquired_ && tonemap_session->IsSameToneMapConfig(layer, blend_cs)) {
-      tonemap_session->current_buffer_index_ = (tonemap_session->current_buffer_index_ + 1) %
-                                                ToneMapSession::kNumIntermediateBuffers;
-      tonemap_session->acquired_ = true;
-      *session_index = i;
-      return kErrorNone;
+  ToneMapConfig config(layer, blend_cs);
+  size_t config_hash = config.Hash();
+
+  // Check if we can re-use an active or a retained tone map session.
+  auto range = session_map_.equal_range(config_hash);
+  for (auto it = range.first; it != range.second; it++) {
+    ToneMapSession *tonemap_session = it->second;
+    if (tonemap_session->acquired_ || !(tonemap_session->tone_map_config_ == config)) {
+      continue;
+    }
+
+    auto idle_it = std::find(idle_sessions_.begin(), idle_sessions_.end(), tonemap_session);
+    if (idle_it != idle_sessions_.end()) {
+      idle_sessions_.erase(idle_it);
+      tone_map_sessions_.push_back(tonemap_session);
     }
+
+    auto active_it = std::find(tone_map_sessions_.begin(), tone_map_sessions_.end(),
+                               tonemap_session);
+    tonemap_session->current_buffer_index_ = (tonemap_session->current_buffer_index_ + 1) %
+                                              ToneMapSession::kNumIntermediateBuffers;
+    tonemap_session->acquired_ = true;
+    *session_index = UINT32(std::distance(tone_map_sessions_.begin(), active_it));
+    session_hits_++;
+    return kErrorNone;
   }
 
+  session_misses_++;
   ToneMapSession *session = new ToneMapSession(buffer_allocator_);
   if (!session) {
     return kErrorMemory;
   }
 
-  session->SetToneMapConfig(layer, blend_cs);
+  session->SetToneMapConfig(config);
 
   ToneMapGetInstanceContext ctx;
   ctx.layer = layer;
@@ -371,6 +608,7 @@ DisplayError HWCToneMapper::AcquireToneMapSession(Layer *layer, uint32_t *sessio
 
   session->acquired_ = true;
   tone_map_sessions_.push_back(session);
+  session_map_.emplace(config_hash, session);
   *session_index = UINT32(tone_map_sessions_.size() - 1);
 
   return kErrorNone;
@@ -38,6 +38,10 @@
 #include <core/layer_stack.h>
 #include <utils/sys.h>
 #include <utils/sync_task.h>
+#include <list>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
 #include <vector>
 #include "hwc_buffer_sync_handler.h"
 #include "hwc_buffer_allocator.h"
@@ -49,6 +53,7 @@ namespace sdm {
 enum class ToneMapTaskCode : int32_t {
   kCodeGetInstance,
   kCodeBlit,
+  kCodeEvict,
   kCodeDestroy,
 };
 
@@ -62,12 +67,55 @@ struct ToneMapBlitContext : public SyncTask<ToneMapTaskCode>::TaskContext {
   shared_ptr<Fence> fence = nullptr;
 };
 
+struct ToneMapEvictContext : public SyncTask<ToneMapTaskCode>::TaskContext {
+  const void *handle = nullptr;
+};
+
 struct ToneMapConfig {
   int type = 0;
   PrimariesTransfer blend_cs = {};
   GammaTransfer transfer = Transfer_Max;
   LayerBufferFormat format = kFormatRGBA8888;
   bool secure = false;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  size_t lut_hash = 0;  // Contents of the 3D LUT and grid the session was built with.
+
+  ToneMapConfig() = default;
+  ToneMapConfig(const Layer *layer, PrimariesTransfer layer_blend_cs);
+  size_t Hash() const;
+  bool operator==(const ToneMapConfig &config) const;
+};
+
+// Intermediate output buffers shared by the tone map sessions of all displays. A session returns
+// its buffers here when it is destroyed, so that a session created later for the same buffer
+// class (size, format, security) can reuse them instead of allocating.
+class ToneMapBufferPool {
+ public:
+  static ToneMapBufferPool *GetInstance();
+  bool Acquire(const BufferConfig &config, BufferInfo *buffer_info,
+               shared_ptr<Fence> *release_fence);
+  void Release(HWCBufferAllocator *buffer_allocator, BufferInfo *buffer_info,
+               const shared_ptr<Fence> &release_fence);
+  void Trim();
+  void Dump(std::ostringstream *os);
+
+  static const uint32_t kMaxPooledBuffers = 4;
+
+ private:
+  struct PooledBuffer {
+    BufferInfo buffer_info = {};
+    shared_ptr<Fence> release_fence = nullptr;
+    HWCBufferAllocator *buffer_allocator = nullptr;
+  };
+
+  static uint64_t GetBufferClass(const BufferConfig &config);
+
+  std::mutex lock_;
+  std::unordered_map<uint64_t, std::vector<PooledBuffer>> free_buffers_ = {};
+  uint32_t pooled_count_ = 0;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
 };
 
 class ToneMapSession : public SyncTask<ToneMapTaskCode>::TaskHandler {
@@ -78,8 +126,7 @@ class ToneMapSession : public SyncTask<ToneMapTaskCode>::TaskHandler {
   void FreeIntermediateBuffers();
   void UpdateBuffer(const shared_ptr<Fence> &acquire_fence, LayerBuffer *buffer);
   void SetReleaseFence(const shared_ptr<Fence> &fd);
-  void SetToneMapConfig(Layer *layer, PrimariesTransfer blend_cs);
-  bool IsSameToneMapConfig(Layer *layer, PrimariesTransfer blend_cs);
+  void SetToneMapConfig(const ToneMapConfig &config);
 
   // TaskHandler methods implementation.
   virtual void OnTask(const ToneMapTaskCode &task_code,
@@ -90,30 +137,54 @@ class ToneMapSession : public SyncTask<ToneMapTaskCode>::TaskHandler {
   Tonemapper *gpu_tone_mapper_ = nullptr;
   HWCBufferAllocator *buffer_allocator_ = nullptr;
   ToneMapConfig tone_map_config_ = {};
+  size_t tone_map_config_hash_ = 0;
   uint8_t current_buffer_index_ = 0;
   std::vector<BufferInfo> buffer_info_ = {};
   shared_ptr<Fence> release_fence_[kNumIntermediateBuffers] = {nullptr, nullptr};
   bool acquired_ = false;
   int layer_index_ = -1;
+  uint32_t idle_frame_count_ = 0;
 };
 
 class HWCToneMapper {
  public:
   explicit HWCToneMapper(HWCBufferAllocator *allocator) : buffer_allocator_(allocator) {}
-  ~HWCToneMapper() {}
+  ~HWCToneMapper() { Terminate(); }
 
   int HandleToneMap(LayerStack *layer_stack);
-  bool IsActive() { return !tone_map_sessions_.empty(); }
+  bool IsActive() {
+    std::lock_guard<std::mutex> lock(lock_);
+    return !tone_map_sessions_.empty();
+  }
   void PostCommit(LayerStack *layer_stack);
   void SetFrameDumpConfig(uint32_t count);
+  void Release();
+  void TrimIdleSessions();
   void Terminate();
+  void Dump(std::ostringstream *os);
+
+  // Sessions can outlive the content they were built for, so switching back to a recently seen
+  // configuration skips the 3D LUT upload and shader build.
+  static const uint32_t kMaxIdleSessions = 4;
+  static const uint32_t kMaxIdleFrames = 120;
 
  private:
+  void TerminateLocked();
   void ToneMap(Layer *layer, ToneMapSession *session);
   DisplayError AcquireToneMapSession(Layer *layer, uint32_t *sess_idx, PrimariesTransfer blend_cs);
   void DumpToneMapOutput(ToneMapSession *session, shared_ptr<sdm::Fence> acquire_fence);
+  void RetainSession(ToneMapSession *session);
+  void DestroySession(ToneMapSession *session);
+  void AgeIdleSessions();
 
+  // Idle sessions are also trimmed from the display event thread once the display goes idle.
+  std::mutex lock_;
   std::vector<ToneMapSession*> tone_map_sessions_;
+  std::list<ToneMapSession*> idle_sessions_;  // Most recently used first.
+  std::unordered_multimap<size_t, ToneMapSession*> session_map_;
+  uint64_t session_hits_ = 0;
+  uint64_t session_misses_ = 0;
+  uint64_t session_evictions_ = 0;
   HWCBufferAllocator *buffer_allocator_ = nullptr;
   uint32_t dump_frame_count_ = 0;
   uint32_t dump_frame_index_ = 0;
@@ -0,0 +1,294 @@
+/*
+* Copyright (c) 2024 The Linux Foundation. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of The Linux Foundation nor the names of its
+*       contributors may be used to endorse or promote products derived
+*       from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+* OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+* IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <TonemapFactory.h>
+
+#include <memory>
+#include <vector>
+
+#include "hwc_tonemapper.h"
+
+using namespace sdm;
+
+namespace {
+
+uint32_t tonemappers_built = 0;
+uint32_t tonemappers_destroyed = 0;
+
+}  // namespace
+
+// The GL tonemapper is replaced at link time, the sessions only need an instance to exist.
+Tonemapper::Tonemapper() {}
+
+Tonemapper::~Tonemapper() {
+  tonemappers_destroyed++;
+}
+
+Tonemapper *Tonemapper::build(int, void *, int, void *, int, bool) {
+  tonemappers_built++;
+  return new Tonemapper();
+}
+
+int Tonemapper::blit(const void *, const void *, int) {
+  return -1;
+}
+
+void Tonemapper::evict(const void *) {
+}
+
+Tonemapper *TonemapperFactory_GetInstance(int type, void *colorMap, int colorMapSize,
+                                          void *lutXform, int lutXformSize, bool isSecure) {
+  return Tonemapper::build(type, colorMap, colorMapSize, lutXform, lutXformSize, isSecure);
+}
+
+namespace {
+
+// Hands out buffers with increasing ids and remembers which ones were freed.
+class FakeAllocator : public HWCBufferAllocator {
+ public:
+  int AllocateBuffer(BufferInfo *buffer_info) {
+    buffer_info->alloc_buffer_info.id = ++allocated;
+    buffer_info->private_data = reinterpret_cast<void *>(buffer_info->alloc_buffer_info.id);
+    return 0;
+  }
+
+  int FreeBuffer(BufferInfo *buffer_info) {
+    freed.push_back(buffer_info->alloc_buffer_info.id);
+    *buffer_info = BufferInfo();
+    return 0;
+  }
+
+  uint64_t allocated = 0;
+  std::vector<uint64_t> freed;
+};
+
+// No real fences are involved, every merge yields no fence.
+class FakeSyncHandler : public BufferSyncHandler {
+ public:
+  int SyncWait(int, int) { return 0; }
+  int SyncMerge(int, int, int *merged_fd) {
+    *merged_fd = -1;
+    return 0;
+  }
+  void GetSyncInfo(int, std::ostringstream *) {}
+};
+
+const uint16_t kLutDim = 2;
+
+class HWCToneMapperTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    Fence::Set(&sync_handler_);
+    tonemappers_built = 0;
+    tonemappers_destroyed = 0;
+  }
+
+  void TearDown() override {
+    ToneMapBufferPool::GetInstance()->Trim();
+  }
+
+  // A layer needing tone mapping into a width x 1080 buffer, with a LUT filled with seed.
+  Layer *AddLayer(uint32_t width, uint8_t seed) {
+    auto lut = std::make_unique<std::vector<Color10Bit>>(kLutDim * kLutDim * kLutDim);
+    memset(lut->data(), seed, lut->size() * sizeof(Color10Bit));
+
+    auto layer = std::make_unique<Layer>();
+    layer->composition = kCompositionGPU;
+    layer->input_buffer.flags.hdr = true;
+    layer->request.flags.tone_map = true;
+    layer->request.width = width;
+    layer->request.height = 1080;
+    layer->request.format = kFormatRGBA8888;
+    layer->lut_3d.dim = kLutDim;
+    layer->lut_3d.lutEntries = lut->data();
+
+    luts_.push_back(std::move(lut));
+    layers_.push_back(std::move(layer));
+    return layers_.back().get();
+  }
+
+  // Runs a frame which tone maps the given layers, or releases the sessions if there are none.
+  void Frame(HWCToneMapper *tone_mapper, const std::vector<Layer *> &layers) {
+    LayerStack layer_stack;
+    layer_stack.layers = layers;
+    if (layers.empty()) {
+      tone_mapper->Release();
+      return;
+    }
+
+    ASSERT_EQ(tone_mapper->HandleToneMap(&layer_stack), 0);
+    tone_mapper->PostCommit(&layer_stack);
+  }
+
+  FakeAllocator allocator_;
+  FakeSyncHandler sync_handler_;
+  std::vector<std::unique_ptr<std::vector<Color10Bit>>> luts_;
+  std::vector<std::unique_ptr<Layer>> layers_;
+};
+
+TEST_F(HWCToneMapperTest, ConfigKeysOnLutContents) {
+  Layer *layer = AddLayer(1920, 1);
+  Layer *same_lut = AddLayer(1920, 1);
+  Layer *other_lut = AddLayer(1920, 2);
+  PrimariesTransfer blend_cs = {};
+
+  ToneMapConfig config(layer, blend_cs);
+  EXPECT_TRUE(config == ToneMapConfig(same_lut, blend_cs));
+  EXPECT_EQ(config.Hash(), ToneMapConfig(same_lut, blend_cs).Hash());
+  EXPECT_FALSE(config == ToneMapConfig(other_lut, blend_cs));
+}
+
+TEST_F(HWCToneMapperTest, SessionReusedForSameLut) {
+  HWCToneMapper tone_mapper(&allocator_);
+  Layer *first = AddLayer(1920, 1);
+  Layer *second = AddLayer(1920, 2);
+  // Same configuration as the first layer, with the LUT in a different allocation.
+  Layer *first_again = AddLayer(1920, 1);
+
+  Frame(&tone_mapper, {first});
+  Frame(&tone_mapper, {second});
+  EXPECT_EQ(tonemappers_built, 2u);
+
+  Frame(&tone_mapper, {first_again});
+  EXPECT_EQ(tonemappers_built, 2u);
+  EXPECT_EQ(tonemappers_destroyed, 0u);
+}
+
+TEST_F(HWCToneMapperTest, IdleSessionsEvictLeastRecentlyUsed) {
+  HWCToneMapper tone_mapper(&allocator_);
+  std::vector<Layer *> layers;
+  for (uint32_t i = 0; i < HWCToneMapper::kMaxIdleSessions + 2; i++) {
+    layers.push_back(AddLayer(1000 + i, 1));
+  }
+
+  // Each frame shows one configuration, the previous session goes idle. After the last one, the
+  // first session is the least recently used one beyond the idle limit.
+  for (auto layer : layers) {
+    Frame(&tone_mapper, {layer});
+  }
+  EXPECT_EQ(tonemappers_built, layers.size());
+  EXPECT_EQ(tonemappers_destroyed, 1u);
+
+  // The second session survived, the first one has to be rebuilt.
+  Frame(&tone_mapper, {layers[1]});
+  EXPECT_EQ(tonemappers_built, layers.size());
+  Frame(&tone_mapper, {layers[0]});
+  EXPECT_EQ(tonemappers_built, layers.size() + 1);
+}
+
+TEST_F(HWCToneMapperTest, IdleSessionsAgeOut) {
+  HWCToneMapper tone_mapper(&allocator_);
+  Layer *layer = AddLayer(1920, 1);
+
+  Frame(&tone_mapper, {layer});
+  for (uint32_t i = 0; i < HWCToneMapper::kMaxIdleFrames; i++) {
+    Frame(&tone_mapper, {});
+  }
+  EXPECT_EQ(tonemappers_destroyed, 0u);
+  EXPECT_FALSE(tone_mapper.IsActive());
+
+  Frame(&tone_mapper, {});
+  EXPECT_EQ(tonemappers_destroyed, 1u);
+}
+
+TEST_F(HWCToneMapperTest, TrimIdleSessionsFreesPooledBuffers) {
+  HWCToneMapper tone_mapper(&allocator_);
+  Layer *active = AddLayer(1920, 1);
+  Layer *idle = AddLayer(1280, 1);
+
+  Frame(&tone_mapper, {idle});
+  Frame(&tone_mapper, {active});
+  EXPECT_EQ(allocator_.allocated, 2u * ToneMapSession::kNumIntermediateBuffers);
+
+  // Only the idle session goes away, its buffers are freed rather than kept in the pool.
+  tone_mapper.TrimIdleSessions();
+  EXPECT_EQ(tonemappers_destroyed, 1u);
+  EXPECT_EQ(allocator_.freed, std::vector<uint64_t>({1, 2}));
+  EXPECT_TRUE(tone_mapper.IsActive());
+}
+
+TEST_F(HWCToneMapperTest, DestroyedSessionBuffersAreReused) {
+  HWCToneMapper tone_mapper(&allocator_);
+  Layer *first = AddLayer(1920, 1);
+  Layer *second = AddLayer(1920, 2);
+
+  Frame(&tone_mapper, {first});
+  for (uint32_t i = 0; i <= HWCToneMapper::kMaxIdleFrames; i++) {
+    Frame(&tone_mapper, {});
+  }
+  EXPECT_EQ(tonemappers_destroyed, 1u);
+
+  // A session of the same size takes over the pooled buffers instead of allocating.
+  Frame(&tone_mapper, {second});
+  EXPECT_EQ(allocator_.allocated, uint64_t(ToneMapSession::kNumIntermediateBuffers));
+  EXPECT_TRUE(allocator_.freed.empty());
+}
+
+TEST_F(HWCToneMapperTest, BufferPoolMatchesBufferClass) {
+  ToneMapBufferPool *buffer_pool = ToneMapBufferPool::GetInstance();
+  BufferInfo buffer_info;
+  buffer_info.buffer_config.width = 1920;
+  buffer_info.buffer_config.height = 1080;
+  allocator_.AllocateBuffer(&buffer_info);
+  BufferConfig config = buffer_info.buffer_config;
+  buffer_pool->Release(&allocator_, &buffer_info, nullptr);
+  EXPECT_EQ(buffer_info.private_data, nullptr);
+
+  BufferConfig secure_config = config;
+  secure_config.secure = true;
+  shared_ptr<Fence> release_fence = nullptr;
+  EXPECT_FALSE(buffer_pool->Acquire(secure_config, &buffer_info, &release_fence));
+
+  EXPECT_TRUE(buffer_pool->Acquire(config, &buffer_info, &release_fence));
+  EXPECT_EQ(buffer_info.alloc_buffer_info.id, 1u);
+  EXPECT_FALSE(buffer_pool->Acquire(config, &buffer_info, &release_fence));
+}
+
+TEST_F(HWCToneMapperTest, BufferPoolFreesBeyondCapacity) {
+  ToneMapBufferPool *buffer_pool = ToneMapBufferPool::GetInstance();
+  for (uint32_t i = 0; i < ToneMapBufferPool::kMaxPooledBuffers + 1; i++) {
+    BufferInfo buffer_info;
+    allocator_.AllocateBuffer(&buffer_info);
+    buffer_pool->Release(&allocator_, &buffer_info, nullptr);
+  }
+  EXPECT_EQ(allocator_.freed,
+            std::vector<uint64_t>({ToneMapBufferPool::kMaxPooledBuffers + 1}));
+
+  buffer_pool->Trim();
+  EXPECT_EQ(allocator_.freed.size(), size_t(ToneMapBufferPool::kMaxPooledBuffers + 1));
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
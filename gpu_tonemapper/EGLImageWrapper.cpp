@@ -26,59 +26,85 @@
 
 #include "EGLImageWrapper.h"
 #include <cutils/native_handle.h>
+#include <gr_utils.h>
 #include <QtiGralloc.h>
 #include <QtiGrallocPriv.h>
 #include <ui/GraphicBuffer.h>
 #include <fcntl.h>
-#include <string>
-#include <map>
-#include <utility>
 #include <sys/stat.h>
+#include "EGLImageBuffer.h"
 
-using std::string;
-using std::map;
-using std::pair;
 using aidl::android::hardware::graphics::common::StandardMetadataType;
 using private_handle_t = qtigralloc::private_handle_t;
 
-static string pidString = std::to_string(getpid());
+static EGLImageBuffer *L_wrap(const private_handle_t *src);
 
 //-----------------------------------------------------------------------------
-static string get_ion_buff_str(int buff_fd)
+static EGLImageBuffer *L_create(const void *pvt_handle)
 //-----------------------------------------------------------------------------
 {
-  string retStr = {};
-  if (buff_fd >= 0) {
-    struct stat stat1;
-    fstat(buff_fd, &stat1);
-    retStr = std::to_string(stat1.st_ino);
-  }
+  return L_wrap(static_cast<const private_handle_t *>(pvt_handle));
+}
 
-  return retStr;
+//-----------------------------------------------------------------------------
+static void L_destroy(EGLImageBuffer *eglImage)
+//-----------------------------------------------------------------------------
+{
+  delete eglImage;
 }
 
 //-----------------------------------------------------------------------------
-void EGLImageWrapper::DeleteEGLImageCallback::operator()(int& buffInt, EGLImageBuffer*& eglImage)
+uint64_t EGLImageWrapper::getBufferId(const void *pvt_handle)
 //-----------------------------------------------------------------------------
 {
-  if (eglImage != 0) {
-    delete eglImage;
+  const private_handle_t *src = static_cast<const private_handle_t *>(pvt_handle);
+  if (src == nullptr) {
+    return 0;
+  }
+
+  // The gralloc id is unique across processes and stays the same for every import of a buffer.
+  if (src->id != 0) {
+    return src->id;
   }
 
-  if (!mapClearPending) {
-    for (auto it = buffStrbuffIntMapPtr->begin(); it != buffStrbuffIntMapPtr->end(); it++) {
-      if (it->second == buffInt /* counter */) {
-        buffStrbuffIntMapPtr->erase(it);
-        return;
-      }
+  // Handles without an id fall back to the dma-buf inode.
+  uint64_t buffId = 0;
+  if (src->fd >= 0) {
+    struct stat stat1;
+    if (fstat(src->fd, &stat1) == 0) {
+      buffId = static_cast<uint64_t>(stat1.st_ino);
     }
   }
+
+  return buffId;
+}
+
+//-----------------------------------------------------------------------------
+void EGLImageWrapper::DeleteEGLImageCallback::operator()(uint64_t& /* buffId */,
+                                                         EGLImageBuffer*& eglImage)
+//-----------------------------------------------------------------------------
+{
+  if (eglImage != 0) {
+    factory->destroy(eglImage);
+    eglImage = 0;
+  }
 }
 
 //-----------------------------------------------------------------------------
 EGLImageWrapper::EGLImageWrapper()
 //-----------------------------------------------------------------------------
 {
+  factory.create = L_create;
+  factory.destroy = L_destroy;
+  factory.getId = getBufferId;
+  Init();
+}
+
+//-----------------------------------------------------------------------------
+EGLImageWrapper::EGLImageWrapper(const ImageFactory &imageFactory)
+//-----------------------------------------------------------------------------
+{
+  factory = imageFactory;
   Init();
 }
 
@@ -93,8 +119,8 @@ EGLImageWrapper::~EGLImageWrapper()
 void EGLImageWrapper::Init()
 //-----------------------------------------------------------------------------
 {
-  eglImageBufferCache = new android::LruCache<int, EGLImageBuffer*>(32);
-  callback = new DeleteEGLImageCallback(&buffStrbuffIntMap);
+  eglImageBufferCache = new android::LruCache<uint64_t, EGLImageBuffer*>(kCacheCapacity);
+  callback = new DeleteEGLImageCallback(&factory);
   eglImageBufferCache->setOnEntryRemovedListener(callback);
 }
 
@@ -103,13 +129,9 @@ void EGLImageWrapper::Deinit()
 //-----------------------------------------------------------------------------
 {
   if (eglImageBufferCache != 0) {
-    if (callback != 0) {
-      callback->mapClearPending = true;
-    }
     eglImageBufferCache->clear();
     delete eglImageBufferCache;
     eglImageBufferCache = 0;
-    buffStrbuffIntMap.clear();
   }
 
   if (callback != 0) {
@@ -164,23 +186,37 @@ static EGLImageBuffer *L_wrap(const private_handle_t *src)
 EGLImageBuffer *EGLImageWrapper::wrap(const void *pvt_handle)
 //-----------------------------------------------------------------------------
 {
-  const private_handle_t *src = static_cast<const private_handle_t *>(pvt_handle);
+  uint64_t buffId = factory.getId(pvt_handle);
+  if (buffId == 0) {
+    ALOGE("Could not provide an eglImage for handle = %p, EGLImageWrapper = %p", pvt_handle, this);
+    return nullptr;
+  }
 
-  string buffStr = get_ion_buff_str(src->fd);
-  EGLImageBuffer* eglImage = nullptr;
-  if (!buffStr.empty()) {
-    auto it = buffStrbuffIntMap.find(buffStr);
-    if (it != buffStrbuffIntMap.end()) {
-      eglImage = eglImageBufferCache->get(it->second);
-    } else {
-        eglImage = L_wrap(src);
-        buffStrbuffIntMap.insert(pair<string, int>(buffStr, buffInt));
-        eglImageBufferCache->put(buffInt, eglImage);
-        buffInt++;
+  EGLImageBuffer* eglImage = eglImageBufferCache->get(buffId);
+  if (eglImage == nullptr) {
+    eglImage = factory.create(pvt_handle);
+    if (eglImage != nullptr) {
+      eglImageBufferCache->put(buffId, eglImage);
     }
-  } else {
-    ALOGE("Could not provide an eglImage for fd = %d, EGLImageWrapper = %p", src->fd, this);
   }
 
   return eglImage;
 }
+
+//-----------------------------------------------------------------------------
+void EGLImageWrapper::evict(const void *pvt_handle)
+//-----------------------------------------------------------------------------
+{
+  uint64_t buffId = factory.getId(pvt_handle);
+  if (buffId != 0) {
+    // Invokes DeleteEGLImageCallback for the entry, if present.
+    eglImageBufferCache->remove(buffId);
+  }
+}
+
+//-----------------------------------------------------------------------------
+size_t EGLImageWrapper::size()
+//-----------------------------------------------------------------------------
+{
+  return eglImageBufferCache->size();
+}
@@ -20,34 +20,46 @@
 #ifndef __TONEMAPPER_EGLIMAGEWRAPPER_H__
 #define __TONEMAPPER_EGLIMAGEWRAPPER_H__
 
+#include <stdint.h>
 #include <utils/LruCache.h>
-#include <string>
-#include <map>
-#include <gr_utils.h>
-#include "EGLImageBuffer.h"
 
-using std::string;
-using std::map;
+class EGLImageBuffer;
 
 class EGLImageWrapper {
+ public:
+  // Identifies, creates and destroys the cached images. The default factory keys on the gralloc
+  // buffer id and wraps the handle in an EGLImage; a stub factory lets the cache bookkeeping run
+  // without a GPU or gralloc handles.
+  struct ImageFactory {
+    EGLImageBuffer *(*create)(const void *pvt_handle);
+    void (*destroy)(EGLImageBuffer *eglImage);
+    uint64_t (*getId)(const void *pvt_handle);
+  };
+
  private:
-  class DeleteEGLImageCallback : public android::OnEntryRemoved<int, EGLImageBuffer*> {
+  class DeleteEGLImageCallback : public android::OnEntryRemoved<uint64_t, EGLImageBuffer*> {
    public:
-     explicit DeleteEGLImageCallback(map<string, int>* mapPtr) { buffStrbuffIntMapPtr = mapPtr; }
-     void operator()(int& buffInt, EGLImageBuffer*& eglImage);
-     map<string, int>* buffStrbuffIntMapPtr = nullptr;
-     bool mapClearPending = false;
+     explicit DeleteEGLImageCallback(const ImageFactory *factoryPtr) : factory(factoryPtr) {}
+     void operator()(uint64_t& buffId, EGLImageBuffer*& eglImage);
+     const ImageFactory *factory = nullptr;
   };
 
-  android::LruCache<int, EGLImageBuffer *>* eglImageBufferCache;
-  map<string, int> buffStrbuffIntMap = {};
+  // Keyed by the gralloc buffer id, so a lookup is a single hash probe in either direction.
+  android::LruCache<uint64_t, EGLImageBuffer *>* eglImageBufferCache = nullptr;
   DeleteEGLImageCallback* callback = 0;
-  uint64_t buffInt = 0;
+  ImageFactory factory = {};
 
  public:
+  static const uint32_t kCacheCapacity = 32;
+
   EGLImageWrapper();
+  explicit EGLImageWrapper(const ImageFactory &imageFactory);
   ~EGLImageWrapper();
   EGLImageBuffer* wrap(const void *pvt_handle);
+  // Drops the image of a buffer which is about to be freed, ahead of LRU eviction.
+  void evict(const void *pvt_handle);
+  size_t size();
+  static uint64_t getBufferId(const void *pvt_handle);
   void Init();
   void Deinit();
 };
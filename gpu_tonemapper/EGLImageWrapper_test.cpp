@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2024, The Linux Foundation. All rights reserved.
+ * Not a Contribution.
+ *
+ * Copyright 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "EGLImageWrapper.h"
+
+namespace {
+
+// Stand-ins for gralloc handles and EGLImages, the cache only looks at their identity.
+struct FakeHandle {
+  uint64_t id;
+};
+
+struct FakeImage {
+  uint64_t id;
+};
+
+std::vector<uint64_t> created;
+std::vector<uint64_t> destroyed;
+
+uint64_t StubGetId(const void *pvt_handle) {
+  return static_cast<const FakeHandle *>(pvt_handle)->id;
+}
+
+EGLImageBuffer *StubCreate(const void *pvt_handle) {
+  created.push_back(StubGetId(pvt_handle));
+  return reinterpret_cast<EGLImageBuffer *>(new FakeImage{StubGetId(pvt_handle)});
+}
+
+void StubDestroy(EGLImageBuffer *eglImage) {
+  FakeImage *image = reinterpret_cast<FakeImage *>(eglImage);
+  destroyed.push_back(image->id);
+  delete image;
+}
+
+uint64_t ImageId(EGLImageBuffer *eglImage) {
+  return reinterpret_cast<FakeImage *>(eglImage)->id;
+}
+
+class EGLImageWrapperTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    created.clear();
+    destroyed.clear();
+  }
+
+  const EGLImageWrapper::ImageFactory factory_ = {StubCreate, StubDestroy, StubGetId};
+};
+
+TEST_F(EGLImageWrapperTest, WrapReusesImageOfSameBuffer) {
+  EGLImageWrapper wrapper(factory_);
+  FakeHandle handle = {7};
+  // A second import of the same buffer has a different handle but the same id.
+  FakeHandle reimport = {7};
+
+  EGLImageBuffer *image = wrapper.wrap(&handle);
+  ASSERT_NE(image, nullptr);
+  EXPECT_EQ(ImageId(image), 7u);
+  EXPECT_EQ(wrapper.wrap(&handle), image);
+  EXPECT_EQ(wrapper.wrap(&reimport), image);
+  EXPECT_EQ(created.size(), 1u);
+  EXPECT_EQ(wrapper.size(), 1u);
+}
+
+TEST_F(EGLImageWrapperTest, WrapRejectsBufferWithoutId) {
+  EGLImageWrapper wrapper(factory_);
+  FakeHandle handle = {0};
+
+  EXPECT_EQ(wrapper.wrap(&handle), nullptr);
+  EXPECT_TRUE(created.empty());
+  EXPECT_EQ(wrapper.size(), 0u);
+}
+
+TEST_F(EGLImageWrapperTest, EvictDestroysImageOfFreedBuffer) {
+  EGLImageWrapper wrapper(factory_);
+  FakeHandle first = {1};
+  FakeHandle second = {2};
+  FakeHandle unknown = {3};
+
+  wrapper.wrap(&first);
+  wrapper.wrap(&second);
+  wrapper.evict(&first);
+  EXPECT_EQ(destroyed, std::vector<uint64_t>({1}));
+  EXPECT_EQ(wrapper.size(), 1u);
+
+  // Evicting a buffer which was never wrapped, or twice, does nothing.
+  wrapper.evict(&unknown);
+  wrapper.evict(&first);
+  EXPECT_EQ(destroyed.size(), 1u);
+
+  // A buffer reallocated after the eviction gets a fresh image.
+  wrapper.wrap(&first);
+  EXPECT_EQ(created, std::vector<uint64_t>({1, 2, 1}));
+}
+
+TEST_F(EGLImageWrapperTest, CapacityEvictsLeastRecentlyUsed) {
+  EGLImageWrapper wrapper(factory_);
+  std::vector<FakeHandle> handles;
+  for (uint64_t id = 1; id <= EGLImageWrapper::kCacheCapacity + 1; id++) {
+    handles.push_back({id});
+  }
+
+  for (uint32_t i = 0; i < EGLImageWrapper::kCacheCapacity; i++) {
+    wrapper.wrap(&handles[i]);
+  }
+  // Touch the oldest entry, so that the second one becomes the least recently used.
+  wrapper.wrap(&handles[0]);
+  EXPECT_TRUE(destroyed.empty());
+
+  wrapper.wrap(&handles[EGLImageWrapper::kCacheCapacity]);
+  EXPECT_EQ(destroyed, std::vector<uint64_t>({2}));
+  EXPECT_EQ(wrapper.size(), size_t(EGLImageWrapper::kCacheCapacity));
+}
+
+TEST_F(EGLImageWrapperTest, DeinitDestroysAllImages) {
+  {
+    EGLImageWrapper wrapper(factory_);
+    FakeHandle first = {1};
+    FakeHandle second = {2};
+    wrapper.wrap(&first);
+    wrapper.wrap(&second);
+  }
+
+  EXPECT_EQ(destroyed.size(), 2u);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
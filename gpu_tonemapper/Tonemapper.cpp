@@ -18,6 +18,7 @@
  */
 #include <utils/Log.h>
 
+#include "EGLImageBuffer.h"
 #include "EGLImageWrapper.h"
 #include "Tonemapper.h"
 #include "engine.h"
@@ -155,3 +156,13 @@ int Tonemapper::blit(const void *dst, const void *src, int srcFenceFd)
 
   return fenceFD;
 }
+
+//-----------------------------------------------------------------------------
+void Tonemapper::evict(const void *handle)
+//-----------------------------------------------------------------------------
+{
+  // make current, the EGLImage owns GL textures and framebuffers
+  engine_bind(engineContext);
+
+  eglImageWrapper->evict(handle);
+}
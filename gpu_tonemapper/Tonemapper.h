@@ -42,6 +42,8 @@ class Tonemapper {
   static Tonemapper *build(int type, void *colorMap, int colorMapSize, void *lutXform,
                            int lutXformSize, bool isSecure);
   int blit(const void *dst, const void *src, int srcFenceFd);
+  // releases the cached EGLImage of a buffer before it is freed
+  void evict(const void *handle);
 };
 
 #endif  //__TONEMAPPER_TONEMAP_H__
@@ -82,15 +82,13 @@ Return<void> QtiAllocator::allocate(const hidl_vec<uint8_t> &descriptor, uint32_
     return Void();
   }
 
+  std::vector<buffer_handle_t> handles;
+  err = buf_mgr_->AllocateBuffers(desc, count, &handles);
+
   std::vector<hidl_handle> buffers;
-  buffers.reserve(count);
-  for (uint32_t i = 0; i < count; i++) {
-    buffer_handle_t buffer;
-    ALOGD_IF(enable_logs_, "buffer: %p", &buffer);
-    err = buf_mgr_->AllocateBuffer(desc, &buffer);
-    if (err != Error::NONE) {
-      break;
-    }
+  buffers.reserve(handles.size());
+  for (auto buffer : handles) {
+    ALOGD_IF(enable_logs_, "buffer: %p", buffer);
     buffers.emplace_back(hidl_handle(buffer));
   }
 
@@ -111,8 +111,30 @@ void AdrenoMemInfo::AdrenoSetProperties(gralloc::GrallocProperties props) {
   gfx_ahardware_buffer_disable_ = props.ahardware_buffer_disable;
 }
 
+bool AdrenoMemInfo::GetCachedAlignment(const AlignmentKey &key, unsigned int *aligned_w,
+                                       unsigned int *aligned_h) {
+  std::pair<unsigned int, unsigned int> aligned;
+  if (!alignment_cache_.Find(key, &aligned)) {
+    return false;
+  }
+
+  *aligned_w = aligned.first;
+  *aligned_h = aligned.second;
+  return true;
+}
+
+void AdrenoMemInfo::CacheAlignment(const AlignmentKey &key, unsigned int aligned_w,
+                                   unsigned int aligned_h) {
+  alignment_cache_.Insert(key, std::make_pair(aligned_w, aligned_h));
+}
+
 void AdrenoMemInfo::AlignUnCompressedRGB(int width, int height, int format, int tile_enabled,
                                          unsigned int *aligned_w, unsigned int *aligned_h) {
+  AlignmentKey key(kAlignUnCompressedRGB, width, height, format, tile_enabled);
+  if (GetCachedAlignment(key, aligned_w, aligned_h)) {
+    return;
+  }
+
   *aligned_w = (unsigned int)ALIGN(width, 32);
   *aligned_h = (unsigned int)ALIGN(height, 32);
 
@@ -161,10 +183,17 @@ void AdrenoMemInfo::AlignUnCompressedRGB(int width, int height, int format, int
         "compute_aligned_width_and_height not found",
         __FUNCTION__);
   }
+
+  CacheAlignment(key, *aligned_w, *aligned_h);
 }
 
 void AdrenoMemInfo::AlignCompressedRGB(int width, int height, int format, unsigned int *aligned_w,
                                        unsigned int *aligned_h) {
+  AlignmentKey key(kAlignCompressedRGB, width, height, format, SURFACE_TILE_MODE_DISABLE);
+  if (GetCachedAlignment(key, aligned_w, aligned_h)) {
+    return;
+  }
+
   if (LINK_adreno_compute_compressedfmt_aligned_width_and_height) {
     int bytesPerPixel = 0;
     surface_rastermode_t raster_mode = SURFACE_RASTER_MODE_UNKNOWN;  // Adreno unknown raster mode.
@@ -178,10 +207,17 @@ void AdrenoMemInfo::AlignCompressedRGB(int width, int height, int format, unsign
     *aligned_h = (unsigned int)ALIGN(height, 32);
     ALOGW("%s: Warning!! compute_compressedfmt_aligned_width_and_height not found", __FUNCTION__);
   }
+
+  CacheAlignment(key, *aligned_w, *aligned_h);
 }
 
 void AdrenoMemInfo::AlignGpuDepthStencilFormat(int width, int height, int format, int tile_enabled,
                                                unsigned int *aligned_w, unsigned int *aligned_h) {
+  AlignmentKey key(kAlignGpuDepthStencil, width, height, format, tile_enabled);
+  if (GetCachedAlignment(key, aligned_w, aligned_h)) {
+    return;
+  }
+
   surface_tile_mode_t tile_mode = static_cast<surface_tile_mode_t>(tile_enabled);
   surface_rastermode_t raster_mode = SURFACE_RASTER_MODE_UNKNOWN;  // Adreno unknown raster mode.
   int padding_threshold = 512;  // Threshold for padding surfaces.
@@ -192,16 +228,26 @@ void AdrenoMemInfo::AlignGpuDepthStencilFormat(int width, int height, int format
         reinterpret_cast<int *>(aligned_h));
   } else {
     ALOGW("%s: Warning!! compute_fmt_aligned_width_and_height not found", __FUNCTION__);
+    return;
   }
+
+  CacheAlignment(key, *aligned_w, *aligned_h);
 }
 
 bool AdrenoMemInfo::IsUBWCSupportedByGPU(int format) {
-  if (!gfx_ubwc_disable_ && LINK_adreno_isUBWCSupportedByGpu) {
-    ADRENOPIXELFORMAT gpu_format = GetGpuPixelFormat(format);
-    return LINK_adreno_isUBWCSupportedByGpu(gpu_format);
+  if (gfx_ubwc_disable_ || !LINK_adreno_isUBWCSupportedByGpu) {
+    return false;
   }
 
-  return false;
+  bool supported = false;
+  if (ubwc_support_cache_.Find(format, &supported)) {
+    return supported;
+  }
+
+  ADRENOPIXELFORMAT gpu_format = GetGpuPixelFormat(format);
+  supported = LINK_adreno_isUBWCSupportedByGpu(gpu_format);
+  ubwc_support_cache_.Insert(format, supported);
+  return supported;
 }
 
 uint32_t AdrenoMemInfo::GetGpuPixelAlignment() {
@@ -33,6 +33,10 @@
 
 #include <display/media/mmm_color_fmt.h>
 
+#include <tuple>
+#include <utility>
+
+#include "gr_memo.h"
 #include "gr_utils.h"
 
 typedef enum {
@@ -219,6 +223,20 @@ class AdrenoMemInfo {
  private:
   AdrenoMemInfo();
   ~AdrenoMemInfo();
+
+  enum AlignmentQuery {
+    kAlignUnCompressedRGB,
+    kAlignCompressedRGB,
+    kAlignGpuDepthStencil,
+  };
+
+  // query, width, height, format, tile mode
+  typedef std::tuple<int, int, int, int, int> AlignmentKey;
+
+  bool GetCachedAlignment(const AlignmentKey &key, unsigned int *aligned_w,
+                          unsigned int *aligned_h);
+  void CacheAlignment(const AlignmentKey &key, unsigned int aligned_w, unsigned int aligned_h);
+
   // link(s)to adreno surface padding library.
   int (*LINK_adreno_compute_padding)(int width, int bpp, int surface_tile_height,
                                      surface_rastermode_t raster_mode,
@@ -253,6 +271,14 @@ class AdrenoMemInfo {
   bool gfx_ahardware_buffer_disable_ = false;
   void *libadreno_utils_ = NULL;
 
+  // libadreno_utils results depend only on their inputs, so they are memoized to keep the
+  // cross-library calls off the allocation and size query paths.
+  static const size_t kMaxAlignmentCacheEntries = 256;
+  static const size_t kMaxUbwcSupportCacheEntries = 64;
+  BoundedMemo<AlignmentKey, std::pair<unsigned int, unsigned int>> alignment_cache_{
+      kMaxAlignmentCacheEntries};
+  BoundedMemo<int, bool> ubwc_support_cache_{kMaxUbwcSupportCacheEntries};
+
   static AdrenoMemInfo *s_instance;
 };
 
@@ -32,6 +32,7 @@
 
 #include <algorithm>
 #include <iomanip>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -302,6 +303,8 @@ Error BufferManager::FreeBuffer(std::shared_ptr<Buffer> buf) {
     return Error::BAD_BUFFER;
   }
 
+  // Hand the metadata mapping back to the map cache, a re-import of this buffer can reuse it
+  UnmapAndReset(const_cast<private_handle_t *>(hnd));
   if (allocator_->FreeBuffer(reinterpret_cast<void *>(hnd->base_metadata), meta_size,
                              hnd->offset_metadata, hnd->fd_metadata, buf->ion_handle_meta) != 0) {
     return Error::BAD_BUFFER;
@@ -596,49 +599,105 @@ static void InitializePrivateHandle(private_handle_t *hnd, int fd, int meta_fd,
   hnd->numFds = private_handle_t::kNumFds;
 }
 
-Error BufferManager::AllocateBuffer(const BufferDescriptor &descriptor, buffer_handle_t *handle,
-                                    unsigned int bufferSize, bool testAlloc) {
-  if (!handle)
-    return Error::BAD_BUFFER;
-  std::lock_guard<std::mutex> buffer_lock(buffer_lock_);
-
+Error BufferManager::GetAllocationLayoutLocked(const BufferDescriptor &descriptor,
+                                               unsigned int bufferSize, AllocationLayout *layout) {
   uint64_t usage = descriptor.GetUsage();
-  int format = GetImplDefinedFormat(usage, descriptor.GetFormat());
-  uint32_t layer_count = descriptor.GetLayerCount();
-
-  unsigned int size;
-  unsigned int alignedw, alignedh;
-  int err = 0;
+  layout->format = GetImplDefinedFormat(usage, descriptor.GetFormat());
+  layout->layer_count = descriptor.GetLayerCount();
+  layout->buffer_type = GetBufferType(layout->format);
 
-  int buffer_type = GetBufferType(format);
   BufferInfo info = GetBufferInfo(descriptor);
-  info.format = format;
-  info.layer_count = layer_count;
+  info.format = layout->format;
+  info.layer_count = layout->layer_count;
 
-  GraphicsMetadata graphics_metadata = {};
-  err = GetBufferSizeAndDimensions(info, &size, &alignedw, &alignedh, &graphics_metadata);
+  int err = GetBufferSizeAndDimensions(info, &layout->size, &layout->alignedw, &layout->alignedh,
+                                       &layout->graphics_metadata);
   if (err == -ENOTSUP) {
     return Error::UNSUPPORTED;
   } else if (err < 0) {
     return Error::BAD_DESCRIPTOR;
   }
 
-  if (size == 0) {
+  if (layout->size == 0) {
     ALOGW("gralloc failed to allocate buffer for size %d format %d AWxAH %dx%d usage %" PRIu64,
-          size, format, alignedw, alignedh, usage);
+          layout->size, layout->format, layout->alignedw, layout->alignedh, usage);
     return Error::UNSUPPORTED;
   }
 
-  if (testAlloc) {
-    return Error::NONE;
+  layout->size = (bufferSize >= layout->size) ? bufferSize : layout->size;
+  layout->custom_content_md_size = GetCustomContentMetadataSize(layout->format, usage);
+  layout->metadata_size = static_cast<unsigned int>(
+      GetMetaDataSize(descriptor.GetReservedSize(), layout->custom_content_md_size));
+  layout->use_adreno_for_size = CanUseAdrenoForSize(layout->buffer_type, usage);
+
+  return Error::NONE;
+}
+
+Error BufferManager::AllocateBuffer(const BufferDescriptor &descriptor, buffer_handle_t *handle,
+                                    unsigned int bufferSize, bool testAlloc) {
+  if (!handle)
+    return Error::BAD_BUFFER;
+  std::lock_guard<std::mutex> buffer_lock(buffer_lock_);
+
+  AllocationLayout layout;
+  auto error = GetAllocationLayoutLocked(descriptor, bufferSize, &layout);
+  if (error != Error::NONE || testAlloc) {
+    return error;
+  }
+
+  return AllocateBufferLocked(descriptor, layout, handle, nullptr);
+}
+
+Error BufferManager::AllocateBuffers(const BufferDescriptor &descriptor, uint32_t count,
+                                     std::vector<buffer_handle_t> *handles) {
+  if (!handles)
+    return Error::BAD_BUFFER;
+  std::lock_guard<std::mutex> buffer_lock(buffer_lock_);
+
+  // Buffers of a batch share one descriptor, so size, alignment and the initial metadata are
+  // computed for the first buffer and reused for the rest.
+  AllocationLayout layout;
+  auto error = GetAllocationLayoutLocked(descriptor, 0, &layout);
+  if (error != Error::NONE) {
+    return error;
   }
 
-  size = (bufferSize >= size) ? bufferSize : size;
+  handles->reserve(handles->size() + count);
+  std::unique_ptr<MetaData_t> metadata_template = nullptr;
+  for (uint32_t i = 0; i < count; i++) {
+    buffer_handle_t handle = nullptr;
+    if (i == 1) {
+      // Capture the metadata the first buffer was initialized with
+      auto hnd = const_cast<private_handle_t *>(QTI_HANDLE_CONST(handles->back()));
+      if (ValidateAndMap(hnd) == 0) {
+        metadata_template = std::make_unique<MetaData_t>();
+        *metadata_template = *reinterpret_cast<MetaData_t *>(hnd->base_metadata);
+        UnmapAndReset(hnd);
+      }
+    }
+    error = AllocateBufferLocked(descriptor, layout, &handle, metadata_template.get());
+    if (error != Error::NONE) {
+      return error;
+    }
+    handles->push_back(handle);
+  }
+
+  return Error::NONE;
+}
+
+Error BufferManager::AllocateBufferLocked(const BufferDescriptor &descriptor,
+                                          const AllocationLayout &layout, buffer_handle_t *handle,
+                                          const MetaData_t *metadata_template) {
+  uint64_t usage = descriptor.GetUsage();
+  int format = layout.format;
+  unsigned int alignedw = layout.alignedw, alignedh = layout.alignedh;
+  int err = 0;
+
   uint64_t flags = 0;
   auto page_size = UINT(getpagesize());
   AllocData data;
   data.align = GetDataAlignment(format, usage);
-  data.size = size;
+  data.size = layout.size;
   data.handle = (uintptr_t)handle;
   data.uncached = UseUncached(format, usage);
 
@@ -646,15 +705,13 @@ Error BufferManager::AllocateBuffer(const BufferDescriptor &descriptor, buffer_h
   err = allocator_->AllocateMem(&data, usage, format);
   if (err) {
     ALOGE("gralloc failed to allocate err=%s format %d size %d WxH %dx%d usage %" PRIu64,
-          strerror(-err), format, size, alignedw, alignedh, usage);
+          strerror(-err), format, layout.size, alignedw, alignedh, usage);
     return Error::NO_RESOURCES;
   }
 
   // Allocate memory for MetaData
   AllocData e_data;
-  uint64_t custom_content_md_reserved_size = GetCustomContentMetadataSize(format, usage);
-  e_data.size = static_cast<unsigned int>(GetMetaDataSize(descriptor.GetReservedSize(),
-                                                          custom_content_md_reserved_size));
+  e_data.size = layout.metadata_size;
   e_data.handle = data.handle;
   e_data.align = page_size;
 
@@ -679,18 +736,18 @@ Error BufferManager::AllocateBuffer(const BufferDescriptor &descriptor, buffer_h
   }
 
   InitializePrivateHandle(hnd, data.fd, e_data.fd, INT(flags), INT(alignedw), INT(alignedh),
-                          descriptor.GetWidth(), descriptor.GetHeight(), format, buffer_type,
-                          data.size, usage);
+                          descriptor.GetWidth(), descriptor.GetHeight(), format,
+                          layout.buffer_type, data.size, usage);
 
   hnd->reserved_size = static_cast<unsigned int>(descriptor.GetReservedSize());
   hnd->id = ++next_id_;
   hnd->base = 0;
   hnd->base_metadata = 0;
-  hnd->layer_count = layer_count;
-  hnd->custom_content_md_reserved_size = custom_content_md_reserved_size;
+  hnd->layer_count = layout.layer_count;
+  hnd->custom_content_md_reserved_size = layout.custom_content_md_size;
 
-  bool use_adreno_for_size = CanUseAdrenoForSize(buffer_type, usage);
-  if (use_adreno_for_size) {
+  if (layout.use_adreno_for_size && !metadata_template) {
+    auto graphics_metadata = layout.graphics_metadata;
     SetMetaData(hnd, QTI_GRAPHICS_METADATA, reinterpret_cast<void *>(&graphics_metadata));
     UnmapAndReset(hnd);
   }
@@ -702,20 +759,24 @@ Error BufferManager::AllocateBuffer(const BufferDescriptor &descriptor, buffer_h
     return Error::BAD_BUFFER;
   }
   auto metadata = reinterpret_cast<MetaData_t *>(hnd->base_metadata);
-  auto nameLength = std::min(descriptor.GetName().size(), size_t(MAX_NAME_LEN - 1));
-  nameLength = descriptor.GetName().copy(metadata->name, nameLength);
-  metadata->name[nameLength] = '\0';
+  if (metadata_template) {
+    *metadata = *metadata_template;
+  } else {
+    auto nameLength = std::min(descriptor.GetName().size(), size_t(MAX_NAME_LEN - 1));
+    nameLength = descriptor.GetName().copy(metadata->name, nameLength);
+    metadata->name[nameLength] = '\0';
 
 #ifdef METADATA_V2
-  metadata->reservedSize = descriptor.GetReservedSize();
+    metadata->reservedSize = descriptor.GetReservedSize();
 #else
-  metadata->reservedRegion.size =
-      std::min(descriptor.GetReservedSize(), (uint64_t)RESERVED_REGION_SIZE);
+    metadata->reservedRegion.size =
+        std::min(descriptor.GetReservedSize(), (uint64_t)RESERVED_REGION_SIZE);
 #endif
-  metadata->crop.top = 0;
-  metadata->crop.left = 0;
-  metadata->crop.right = hnd->width;
-  metadata->crop.bottom = hnd->height;
+    metadata->crop.top = 0;
+    metadata->crop.left = 0;
+    metadata->crop.right = hnd->width;
+    metadata->crop.bottom = hnd->height;
+  }
 
   UnmapAndReset(hnd);
 
@@ -791,6 +852,10 @@ Error BufferManager::Dump(std::ostringstream *os) {
         << "0x" << std::setw(8) << hnd->format;
     *os << std::dec << std::setfill(' ') << std::endl;
   }
+  MetadataMapStats map_stats;
+  GetMetadataMapStats(&map_stats);
+  *os << "metadata maps: hits: " << map_stats.hits << " misses: " << map_stats.misses;
+  *os << " parked: " << map_stats.parked << std::endl;
   return Error::NONE;
 }
 
@@ -897,6 +962,27 @@ static Error GetCustomMetadataHelper(void *custom_content_md_region_ptr,
 }
 #endif
 
+static bool IsMetadataConstant(int64_t metadatatype_value) {
+  switch (metadatatype_value) {
+    case (int64_t)StandardMetadataType::BUFFER_ID:
+    case (int64_t)StandardMetadataType::NAME:
+    case (int64_t)StandardMetadataType::WIDTH:
+    case (int64_t)StandardMetadataType::HEIGHT:
+    case (int64_t)StandardMetadataType::LAYER_COUNT:
+    case (int64_t)StandardMetadataType::PIXEL_FORMAT_REQUESTED:
+    case (int64_t)StandardMetadataType::PIXEL_FORMAT_FOURCC:
+    case (int64_t)StandardMetadataType::PIXEL_FORMAT_MODIFIER:
+    case (int64_t)StandardMetadataType::USAGE:
+    case (int64_t)StandardMetadataType::ALLOCATION_SIZE:
+    case (int64_t)StandardMetadataType::PROTECTED_CONTENT:
+    case (int64_t)StandardMetadataType::CHROMA_SITING:
+    case (int64_t)StandardMetadataType::COMPRESSION:
+      return true;
+    default:
+      return false;
+  }
+}
+
 Error BufferManager::GetMetadata(private_handle_t *handle, int64_t metadatatype_value,
                                  hidl_vec<uint8_t> *out) {
   std::lock_guard<std::mutex> lock(buffer_lock_);
@@ -910,6 +996,29 @@ Error BufferManager::GetMetadata(private_handle_t *handle, int64_t metadatatype_
     return Error::BAD_BUFFER;
   }
 
+  if (IsMetadataConstant(metadatatype_value)) {
+    auto it = buf->encoded_metadata.find(metadatatype_value);
+    if (it != buf->encoded_metadata.end()) {
+      *out = it->second;
+      return Error::NONE;
+    }
+  } else if (metadatatype_value == (int64_t)StandardMetadataType::PLANE_LAYOUTS) {
+    // Plane layouts follow the linear format once a UBWC buffer has been rendered linear
+    int32_t format = handle->format;
+    int linear_format = 0;
+    if (GetMetaDataValue(handle, QTI_LINEAR_FORMAT, &linear_format) == Error::NONE) {
+      format = INT(linear_format);
+    }
+    if (buf->plane_layouts_format != format) {
+      std::vector<PlaneLayout> plane_layouts;
+      GetPlaneLayout(handle, &plane_layouts);
+      android::gralloc4::encodePlaneLayouts(plane_layouts, &buf->encoded_plane_layouts);
+      buf->plane_layouts_format = format;
+    }
+    *out = buf->encoded_plane_layouts;
+    return Error::NONE;
+  }
+
   auto metadata = reinterpret_cast<MetaData_t *>(handle->base_metadata);
 
   void *metadata_ptr = nullptr;
@@ -1031,12 +1140,6 @@ Error BufferManager::GetMetadata(private_handle_t *handle, int64_t metadatatype_
         android::gralloc4::encodeCompression(android::gralloc4::Compression_None, out);
       }
       break;
-    case (int64_t)StandardMetadataType::PLANE_LAYOUTS: {
-      std::vector<PlaneLayout> plane_layouts;
-      GetPlaneLayout(handle, &plane_layouts);
-      android::gralloc4::encodePlaneLayouts(plane_layouts, out);
-      break;
-    }
     case (int64_t)StandardMetadataType::BLEND_MODE:
       if (metadata_ptr != nullptr) {
         android::gralloc4::encodeBlendMode(*reinterpret_cast<BlendMode *>(metadata_ptr), out);
@@ -1144,7 +1247,8 @@ Error BufferManager::GetMetadata(private_handle_t *handle, int64_t metadatatype_
       }
       break;
     case QTI_GRAPHICS_METADATA:
-      if (metadata_ptr != nullptr) {
+      // Bulk payloads are not copied between buffers while unset, so gate on the status.
+      if (metadata_ptr != nullptr && getGralloc4Array(metadata, metadatatype_value)) {
         qtigralloc::encodeGraphicsMetadata(*reinterpret_cast<GraphicsMetadata *>(metadata_ptr),
                                            out);
       } else {
@@ -1191,14 +1295,14 @@ Error BufferManager::GetMetadata(private_handle_t *handle, int64_t metadatatype_
       }
       break;
     case QTI_CVP_METADATA:
-      if (metadata_ptr != nullptr) {
+      if (metadata_ptr != nullptr && getGralloc4Array(metadata, metadatatype_value)) {
         qtigralloc::encodeCVPMetadata(*reinterpret_cast<CVPMetadata *>(metadata_ptr), out);
       } else {
         return Error::BAD_VALUE;
       }
       break;
     case QTI_VIDEO_HISTOGRAM_STATS:
-      if (metadata_ptr != nullptr) {
+      if (metadata_ptr != nullptr && getGralloc4Array(metadata, metadatatype_value)) {
         qtigralloc::encodeVideoHistogramMetadata(
             *reinterpret_cast<VideoHistogramMetadata *>(metadata_ptr), out);
       } else {
@@ -1407,6 +1511,10 @@ Error BufferManager::GetMetadata(private_handle_t *handle, int64_t metadatatype_
       error = Error::UNSUPPORTED;
   }
 
+  if (error == Error::NONE && IsMetadataConstant(metadatatype_value)) {
+    buf->encoded_metadata[metadatatype_value] = *out;
+  }
+
   return error;
 }
 
@@ -1636,6 +1744,8 @@ Error BufferManager::SetMetadata(private_handle_t *handle, int64_t metadatatype_
                                       &metadata->linearFormat)) {
         return Error::UNSUPPORTED;
       }
+      // Plane layouts depend on the linear format, re-derive them on the next query
+      buf->plane_layouts_format = -1;
       break;
     case QTI_SINGLE_BUFFER_MODE:
       if (android::gralloc4::decodeUint32(qtigralloc::MetadataType_SingleBufferMode, in,
@@ -44,6 +44,10 @@ class BufferManager {
 
   Error AllocateBuffer(const BufferDescriptor &descriptor, buffer_handle_t *handle,
                        unsigned int bufferSize = 0, bool testAlloc = false);
+  // Allocates count buffers of the same descriptor, appending them to handles.
+  // On failure, handles holds the buffers allocated so far, which the caller must release.
+  Error AllocateBuffers(const BufferDescriptor &descriptor, uint32_t count,
+                        std::vector<buffer_handle_t> *handles);
   Error RetainBuffer(private_handle_t const *hnd);
   Error ReleaseBuffer(private_handle_t const *hnd);
   Error LockBuffer(const private_handle_t *hnd, uint64_t usage);
@@ -99,8 +103,34 @@ class BufferManager {
     void *reserved_region_ptr = nullptr;
     uint64_t custom_content_md_size = 0;
     void *custom_content_md_region_ptr = nullptr;
+    // Encoded metadata that is fixed at allocation, filled on first query
+    std::unordered_map<int64_t, hidl_vec<uint8_t>> encoded_metadata;
+    // Encoded plane layouts and the format they were computed for, which changes
+    // when the buffer is rendered linear
+    hidl_vec<uint8_t> encoded_plane_layouts;
+    int32_t plane_layouts_format = -1;
   };
 
+  // Properties shared by every buffer allocated from one descriptor
+  struct AllocationLayout {
+    int format = 0;
+    uint32_t layer_count = 1;
+    int buffer_type = 0;
+    unsigned int size = 0;
+    unsigned int alignedw = 0;
+    unsigned int alignedh = 0;
+    GraphicsMetadata graphics_metadata = {};
+    uint64_t custom_content_md_size = 0;
+    unsigned int metadata_size = 0;
+    bool use_adreno_for_size = false;
+  };
+
+  Error GetAllocationLayoutLocked(const BufferDescriptor &descriptor, unsigned int bufferSize,
+                                  AllocationLayout *layout);
+  // Allocates a buffer for a computed layout. The metadata region is copied from
+  // metadata_template when given, instead of being initialized field by field.
+  Error AllocateBufferLocked(const BufferDescriptor &descriptor, const AllocationLayout &layout,
+                             buffer_handle_t *handle, const MetaData_t *metadata_template);
   Error FreeBuffer(std::shared_ptr<Buffer> buf);
 
   // Get the wrapper Buffer object from the handle, returns nullptr if handle is not found
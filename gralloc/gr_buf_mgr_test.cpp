@@ -0,0 +1,257 @@
+/*
+* Copyright (c) 2024 The Linux Foundation. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of The Linux Foundation nor the names of its
+*       contributors may be used to endorse or promote products derived
+*       from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+* OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+* IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gralloctypes/Gralloc4.h>
+#include <gtest/gtest.h>
+#include <QtiGralloc.h>
+
+#include <cstring>
+#include <vector>
+
+#include "gr_buf_mgr.h"
+
+namespace {
+
+using aidl::android::hardware::graphics::common::PlaneLayout;
+using gralloc::BufferDescriptor;
+using gralloc::BufferManager;
+using gralloc::Error;
+using android::hardware::hidl_vec;
+
+const int kWidth = 1920;
+const int kHeight = 1080;
+
+// Allocates real buffers, so this runs on target against the device heaps.
+class BufferManagerTest : public ::testing::Test {
+ protected:
+  void SetUp() override { buf_mgr_ = BufferManager::GetInstance(); }
+
+  void TearDown() override {
+    for (auto handle : handles_) {
+      buf_mgr_->ReleaseBuffer(QTI_HANDLE_CONST(handle));
+    }
+  }
+
+  BufferDescriptor Descriptor(int format) {
+    BufferDescriptor descriptor;
+    descriptor.SetDimensions(kWidth, kHeight);
+    descriptor.SetColorFormat(format);
+    descriptor.SetUsage(static_cast<uint64_t>(BufferUsage::GPU_TEXTURE) |
+                        static_cast<uint64_t>(BufferUsage::GPU_RENDER_TARGET));
+    descriptor.SetName("gr_buf_mgr_test");
+    return descriptor;
+  }
+
+  private_handle_t *Allocate(int format) {
+    buffer_handle_t handle = nullptr;
+    if (buf_mgr_->AllocateBuffer(Descriptor(format), &handle) != Error::NONE) {
+      return nullptr;
+    }
+    handles_.push_back(handle);
+    return Map(handle);
+  }
+
+  std::vector<private_handle_t *> AllocateBatch(int format, uint32_t count) {
+    std::vector<buffer_handle_t> batch;
+    auto error = buf_mgr_->AllocateBuffers(Descriptor(format), count, &batch);
+    handles_.insert(handles_.end(), batch.begin(), batch.end());
+    std::vector<private_handle_t *> out;
+    if (error != Error::NONE) {
+      return out;
+    }
+    for (auto handle : batch) {
+      out.push_back(Map(handle));
+    }
+    return out;
+  }
+
+  // The allocator leaves the metadata unmapped, map it as an importing client would
+  private_handle_t *Map(buffer_handle_t handle) {
+    auto hnd = const_cast<private_handle_t *>(QTI_HANDLE_CONST(handle));
+    if (gralloc::ValidateAndMap(hnd) != 0) {
+      return nullptr;
+    }
+    return hnd;
+  }
+
+  // A batch allocation must be indistinguishable from allocating each buffer on its own
+  void ExpectBatchMatchesSingles(int format) {
+    const uint32_t count = 3;
+    auto batch = AllocateBatch(format, count);
+    ASSERT_EQ(batch.size(), count);
+
+    for (uint32_t i = 0; i < count; i++) {
+      private_handle_t *single = Allocate(format);
+      ASSERT_NE(single, nullptr);
+      ASSERT_NE(batch[i], nullptr);
+
+      EXPECT_EQ(batch[i]->size, single->size);
+      EXPECT_EQ(batch[i]->width, single->width);
+      EXPECT_EQ(batch[i]->height, single->height);
+      EXPECT_EQ(batch[i]->unaligned_width, single->unaligned_width);
+      EXPECT_EQ(batch[i]->unaligned_height, single->unaligned_height);
+      EXPECT_EQ(batch[i]->format, single->format);
+      EXPECT_EQ(batch[i]->flags, single->flags);
+      EXPECT_EQ(batch[i]->buffer_type, single->buffer_type);
+      EXPECT_EQ(batch[i]->layer_count, single->layer_count);
+      EXPECT_EQ(batch[i]->usage, single->usage);
+      EXPECT_EQ(batch[i]->reserved_size, single->reserved_size);
+
+      // Buffers after the first get the metadata copied from it, which must hold exactly
+      // what a per-buffer initialization writes: name, crop, reserved size and the
+      // graphics metadata of adreno sized buffers.
+      EXPECT_EQ(memcmp(reinterpret_cast<void *>(batch[i]->base_metadata),
+                       reinterpret_cast<void *>(single->base_metadata), sizeof(MetaData_t)),
+                0)
+          << "metadata of buffer " << i << " differs";
+    }
+
+    for (uint32_t i = 1; i < count; i++) {
+      EXPECT_GT(batch[i]->id, batch[i - 1]->id);
+    }
+  }
+
+  // Plane layouts encoded straight from the handle, bypassing the per-buffer cache.
+  hidl_vec<uint8_t> EncodedPlaneLayouts(private_handle_t *handle) {
+    std::vector<PlaneLayout> plane_layouts;
+    gralloc::GetPlaneLayout(handle, &plane_layouts);
+    hidl_vec<uint8_t> out;
+    android::gralloc4::encodePlaneLayouts(plane_layouts, &out);
+    return out;
+  }
+
+  BufferManager *buf_mgr_ = nullptr;
+  std::vector<buffer_handle_t> handles_;
+};
+
+TEST_F(BufferManagerTest, ConstantMetadataServedFromCache) {
+  private_handle_t *handle = Allocate(HAL_PIXEL_FORMAT_RGBA_8888);
+  ASSERT_NE(handle, nullptr);
+
+  hidl_vec<uint8_t> first, second;
+  ASSERT_EQ(buf_mgr_->GetMetadata(handle, (int64_t)StandardMetadataType::WIDTH, &first),
+            Error::NONE);
+  ASSERT_EQ(buf_mgr_->GetMetadata(handle, (int64_t)StandardMetadataType::WIDTH, &second),
+            Error::NONE);
+  EXPECT_EQ(first, second);
+  uint64_t width = 0;
+  ASSERT_EQ(android::gralloc4::decodeWidth(second, &width), android::NO_ERROR);
+  EXPECT_EQ(width, uint64_t(kWidth));
+
+  hidl_vec<uint8_t> encoded_id;
+  ASSERT_EQ(buf_mgr_->GetMetadata(handle, (int64_t)StandardMetadataType::BUFFER_ID, &encoded_id),
+            Error::NONE);
+  uint64_t id = 0;
+  ASSERT_EQ(android::gralloc4::decodeBufferId(encoded_id, &id), android::NO_ERROR);
+  EXPECT_EQ(id, handle->id);
+}
+
+TEST_F(BufferManagerTest, ConstantMetadataRejectsSet) {
+  private_handle_t *handle = Allocate(HAL_PIXEL_FORMAT_RGBA_8888);
+  ASSERT_NE(handle, nullptr);
+
+  hidl_vec<uint8_t> before;
+  ASSERT_EQ(buf_mgr_->GetMetadata(handle, (int64_t)StandardMetadataType::WIDTH, &before),
+            Error::NONE);
+
+  hidl_vec<uint8_t> in;
+  android::gralloc4::encodeWidth(kWidth / 2, &in);
+  EXPECT_EQ(buf_mgr_->SetMetadata(handle, (int64_t)StandardMetadataType::WIDTH, in),
+            Error::BAD_VALUE);
+
+  hidl_vec<uint8_t> after;
+  ASSERT_EQ(buf_mgr_->GetMetadata(handle, (int64_t)StandardMetadataType::WIDTH, &after),
+            Error::NONE);
+  EXPECT_EQ(after, before);
+}
+
+TEST_F(BufferManagerTest, PlaneLayoutsFollowLinearFormat) {
+  private_handle_t *handle = Allocate(HAL_PIXEL_FORMAT_YCbCr_420_SP_VENUS_UBWC);
+  ASSERT_NE(handle, nullptr);
+
+  hidl_vec<uint8_t> ubwc;
+  ASSERT_EQ(buf_mgr_->GetMetadata(handle, (int64_t)StandardMetadataType::PLANE_LAYOUTS, &ubwc),
+            Error::NONE);
+  EXPECT_EQ(ubwc, EncodedPlaneLayouts(handle));
+
+  // A producer rendering the buffer linear must invalidate the cached layouts.
+  hidl_vec<uint8_t> in;
+  android::gralloc4::encodeUint32(qtigralloc::MetadataType_LinearFormat,
+                                  HAL_PIXEL_FORMAT_YCbCr_420_SP_VENUS, &in);
+  ASSERT_EQ(buf_mgr_->SetMetadata(handle, QTI_LINEAR_FORMAT, in), Error::NONE);
+
+  hidl_vec<uint8_t> linear;
+  ASSERT_EQ(buf_mgr_->GetMetadata(handle, (int64_t)StandardMetadataType::PLANE_LAYOUTS, &linear),
+            Error::NONE);
+  EXPECT_EQ(linear, EncodedPlaneLayouts(handle));
+  EXPECT_NE(linear, ubwc);
+}
+
+TEST_F(BufferManagerTest, PlaneLayoutsFollowLinearFormatWrittenElsewhere) {
+  private_handle_t *handle = Allocate(HAL_PIXEL_FORMAT_YCbCr_420_SP_VENUS_UBWC);
+  ASSERT_NE(handle, nullptr);
+
+  hidl_vec<uint8_t> ubwc;
+  ASSERT_EQ(buf_mgr_->GetMetadata(handle, (int64_t)StandardMetadataType::PLANE_LAYOUTS, &ubwc),
+            Error::NONE);
+
+  // Another process sharing the buffer writes the metadata region without going through
+  // this BufferManager.
+  uint32_t linear_format = HAL_PIXEL_FORMAT_YCbCr_420_SP_VENUS;
+  ASSERT_EQ(gralloc::SetMetaData(handle, QTI_LINEAR_FORMAT, &linear_format), Error::NONE);
+
+  hidl_vec<uint8_t> linear;
+  ASSERT_EQ(buf_mgr_->GetMetadata(handle, (int64_t)StandardMetadataType::PLANE_LAYOUTS, &linear),
+            Error::NONE);
+  EXPECT_EQ(linear, EncodedPlaneLayouts(handle));
+  EXPECT_NE(linear, ubwc);
+}
+
+TEST_F(BufferManagerTest, BatchMatchesSingleAllocationsRgb) {
+  ExpectBatchMatchesSingles(HAL_PIXEL_FORMAT_RGBA_8888);
+}
+
+TEST_F(BufferManagerTest, BatchMatchesSingleAllocationsYuv) {
+  ExpectBatchMatchesSingles(HAL_PIXEL_FORMAT_YCbCr_420_SP_VENUS_UBWC);
+}
+
+TEST_F(BufferManagerTest, BatchRejectsInvalidDescriptor) {
+  std::vector<buffer_handle_t> batch;
+  BufferDescriptor invalid = Descriptor(HAL_PIXEL_FORMAT_RGBA_8888);
+  invalid.SetDimensions(0, 0);
+  EXPECT_NE(buf_mgr_->AllocateBuffers(invalid, 2, &batch), Error::NONE);
+  EXPECT_TRUE(batch.empty());
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
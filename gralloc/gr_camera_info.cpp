@@ -37,6 +37,7 @@
 
 #include <dlfcn.h>
 #include <log/log.h>
+#include <algorithm>
 #include <mutex>
 
 #include "gr_camera_info.h"
@@ -159,9 +160,16 @@ CamxPixelFormat CameraInfo::GetCameraPixelFormat(int hal_format) {
 int CameraInfo::GetBufferSize(int format, int width, int height, unsigned int *size) {
   CamxFormatResult result = (CamxFormatResult)-1;
   if (LINK_camera_get_buffer_size) {
+    FormatKey key(format, width, height);
+    if (buffer_size_cache_.Find(key, size)) {
+      return 0;
+    }
+
     result = LINK_camera_get_buffer_size(GetCameraPixelFormat(format), width, height, size);
     if (result != 0) {
       ALOGE("%s: Failed to get the buffer size. Error code: %d", __FUNCTION__, result);
+    } else {
+      buffer_size_cache_.Insert(key, *size);
     }
   } else {
     ALOGW("%s: Failed to link CamxFormatUtil_GetBufferSize. Error code : %d", __FUNCTION__, result);
@@ -305,6 +313,27 @@ int CameraInfo::GetPlaneSize(int format, int plane_type, int width, int height,
 
 int CameraInfo::GetCameraFormatPlaneInfo(int format, int width, int height, int *plane_count,
                                          PlaneLayoutInfo *plane_info) {
+  FormatKey key(format, width, height);
+  PlaneInfoEntry entry;
+  if (plane_info_cache_.Find(key, &entry)) {
+    *plane_count = entry.plane_count;
+    std::copy_n(entry.plane_info.begin(), entry.plane_count, plane_info);
+    return 0;
+  }
+
+  int result = QueryCameraFormatPlaneInfo(format, width, height, plane_count, plane_info);
+  if (result != 0 || *plane_count < 0 || *plane_count > 8) {
+    return result;
+  }
+
+  entry.plane_count = *plane_count;
+  std::copy_n(plane_info, *plane_count, entry.plane_info.begin());
+  plane_info_cache_.Insert(key, entry);
+  return result;
+}
+
+int CameraInfo::QueryCameraFormatPlaneInfo(int format, int width, int height, int *plane_count,
+                                           PlaneLayoutInfo *plane_info) {
   int h_subsampling = 0;
   int v_subsampling = 0;
   int offset = 0;
@@ -36,6 +36,10 @@
 #ifndef __GR_CAMERA_INFO_H__
 #define __GR_CAMERA_INFO_H__
 
+#include <array>
+#include <tuple>
+
+#include "gr_memo.h"
 #include "gr_utils.h"
 
 // Plane types supported by the camera format
@@ -147,6 +151,17 @@ class CameraInfo {
 
   CamxPlaneType GetCamxPlaneType(int plane_type);
 
+  int QueryCameraFormatPlaneInfo(int format, int width, int height, int *plane_count,
+                                 PlaneLayoutInfo *plane_info);
+
+  // format, width, height
+  typedef std::tuple<int, int, int> FormatKey;
+
+  struct PlaneInfoEntry {
+    int plane_count = 0;
+    std::array<PlaneLayoutInfo, 8> plane_info = {};
+  };
+
   CamxFormatResult (*LINK_camera_get_stride_in_bytes)(CamxPixelFormat format,
                                                       CamxPlaneType plane_type, int width,
                                                       int *stride) = nullptr;
@@ -204,6 +219,13 @@ class CameraInfo {
                                                                     int *pAlignment) = nullptr;
 
   void *libcamera_utils_ = nullptr;
+
+  // Results of the camera format queries depend only on their inputs. Memoize the ones issued on
+  // every allocation and size query, which otherwise cost several library calls per plane.
+  static const size_t kMaxCacheEntries = 64;
+  BoundedMemo<FormatKey, unsigned int> buffer_size_cache_{kMaxCacheEntries};
+  BoundedMemo<FormatKey, PlaneInfoEntry> plane_info_cache_{kMaxCacheEntries};
+
   static CameraInfo *s_instance;
 };
 
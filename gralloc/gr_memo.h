@@ -0,0 +1,82 @@
+/*
+* Copyright (c) 2024 The Linux Foundation. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of The Linux Foundation nor the names of its
+*       contributors may be used to endorse or promote products derived
+*       from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+* OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+* IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef __GR_MEMO_H__
+#define __GR_MEMO_H__
+
+#include <map>
+#include <mutex>
+
+namespace gralloc {
+
+// Thread safe memo of a query whose result depends only on its key. Once max_entries are
+// held, inserting a new key clears the memo, which bounds it without tracking recency.
+template <class Key, class Value>
+class BoundedMemo {
+ public:
+  explicit BoundedMemo(size_t max_entries) : max_entries_(max_entries) {}
+
+  bool Find(const Key &key, Value *value) {
+    std::lock_guard<std::mutex> lock(lock_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+      return false;
+    }
+
+    *value = it->second;
+    return true;
+  }
+
+  void Insert(const Key &key, const Value &value) {
+    std::lock_guard<std::mutex> lock(lock_);
+    if (entries_.size() >= max_entries_ && entries_.find(key) == entries_.end()) {
+      entries_.clear();
+    }
+    entries_[key] = value;
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(lock_);
+    entries_.clear();
+  }
+
+  size_t Size() {
+    std::lock_guard<std::mutex> lock(lock_);
+    return entries_.size();
+  }
+
+ private:
+  const size_t max_entries_;
+  std::mutex lock_;
+  std::map<Key, Value> entries_;
+};
+
+}  // namespace gralloc
+
+#endif  // __GR_MEMO_H__
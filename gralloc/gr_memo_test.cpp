@@ -0,0 +1,121 @@
+/*
+* Copyright (c) 2024 The Linux Foundation. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of The Linux Foundation nor the names of its
+*       contributors may be used to endorse or promote products derived
+*       from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+* OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+* IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <tuple>
+
+#include "gr_memo.h"
+
+namespace {
+
+using gralloc::BoundedMemo;
+
+// Same shape as the camera format key: format, width, height
+typedef std::tuple<int, int, int> Key;
+
+TEST(BoundedMemoTest, FindReturnsInsertedValue) {
+  BoundedMemo<Key, unsigned int> memo(4);
+  memo.Insert(Key(1, 1920, 1080), 100);
+
+  unsigned int value = 0;
+  EXPECT_TRUE(memo.Find(Key(1, 1920, 1080), &value));
+  EXPECT_EQ(value, 100u);
+}
+
+TEST(BoundedMemoTest, MissLeavesValueUntouched) {
+  BoundedMemo<Key, unsigned int> memo(4);
+  memo.Insert(Key(1, 1920, 1080), 100);
+
+  // Each field of the key takes part in the lookup.
+  unsigned int value = 7;
+  EXPECT_FALSE(memo.Find(Key(2, 1920, 1080), &value));
+  EXPECT_FALSE(memo.Find(Key(1, 1080, 1920), &value));
+  EXPECT_FALSE(memo.Find(Key(1, 1920, 1088), &value));
+  EXPECT_EQ(value, 7u);
+}
+
+TEST(BoundedMemoTest, ClearsOnceFull) {
+  const size_t max_entries = 4;
+  BoundedMemo<Key, unsigned int> memo(max_entries);
+  for (int i = 0; i < static_cast<int>(max_entries); i++) {
+    memo.Insert(Key(i, 64, 64), i);
+  }
+  EXPECT_EQ(memo.Size(), max_entries);
+
+  unsigned int value = 0;
+  for (int i = 0; i < static_cast<int>(max_entries); i++) {
+    EXPECT_TRUE(memo.Find(Key(i, 64, 64), &value));
+  }
+
+  // The next new key does not fit, so the memo starts over with it.
+  memo.Insert(Key(100, 64, 64), 100);
+  EXPECT_EQ(memo.Size(), 1u);
+  EXPECT_FALSE(memo.Find(Key(0, 64, 64), &value));
+  EXPECT_TRUE(memo.Find(Key(100, 64, 64), &value));
+  EXPECT_EQ(value, 100u);
+}
+
+TEST(BoundedMemoTest, UpdateWhenFullKeepsEntries) {
+  const size_t max_entries = 2;
+  BoundedMemo<Key, unsigned int> memo(max_entries);
+  memo.Insert(Key(0, 64, 64), 0);
+  memo.Insert(Key(1, 64, 64), 1);
+
+  memo.Insert(Key(1, 64, 64), 11);
+  EXPECT_EQ(memo.Size(), max_entries);
+
+  unsigned int value = 0;
+  EXPECT_TRUE(memo.Find(Key(0, 64, 64), &value));
+  EXPECT_EQ(value, 0u);
+  EXPECT_TRUE(memo.Find(Key(1, 64, 64), &value));
+  EXPECT_EQ(value, 11u);
+}
+
+TEST(BoundedMemoTest, ClearDropsAllEntries) {
+  BoundedMemo<int, bool> memo(4);
+  memo.Insert(1, true);
+  memo.Insert(2, false);
+
+  memo.Clear();
+  EXPECT_EQ(memo.Size(), 0u);
+  bool value = false;
+  EXPECT_FALSE(memo.Find(1, &value));
+
+  memo.Insert(1, true);
+  EXPECT_TRUE(memo.Find(1, &value));
+  EXPECT_TRUE(value);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -35,10 +35,16 @@
 #include <display/drm/sde_drm.h>
 #include <drm/drm_fourcc.h>
 
+#include <pthread.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <cutils/properties.h>
 #include <algorithm>
+#include <chrono>
+#include <deque>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "gr_adreno_info.h"
@@ -2196,11 +2202,130 @@ uint64_t GetMetaDataSize(uint64_t reserved_region_size, uint64_t custom_content_
                                                  custom_content_md_region_size));
 }
 
+// Metadata regions unmapped from a handle are parked here for a short while, keyed by the
+// identity of the underlying buffer, so that a re-import or re-map of the same buffer reuses
+// the mapping instead of another mmap/munmap pair. A parked mapping belongs to no handle.
+// A detached reaper thread runs only while mappings are parked and unmaps them as they expire,
+// so an idle process does not keep their buffers pinned.
+class MetadataMapCache {
+ public:
+  void *Take(int fd, uint64_t size) {
+    std::lock_guard<std::mutex> lock(lock_);
+    EvictExpiredLocked();
+    struct stat st = {};
+    if (parked_.empty() || fstat(fd, &st) != 0) {
+      stats_.misses++;
+      return nullptr;
+    }
+    for (auto it = parked_.begin(); it != parked_.end(); it++) {
+      if (it->dev == st.st_dev && it->ino == st.st_ino && it->size == size) {
+        void *base = it->base;
+        parked_.erase(it);
+        stats_.hits++;
+        return base;
+      }
+    }
+    stats_.misses++;
+    return nullptr;
+  }
+
+  void Park(int fd, void *base, uint64_t size) {
+    struct stat st = {};
+    if (fd < 0 || fstat(fd, &st) != 0) {
+      munmap(base, size);
+      return;
+    }
+    std::lock_guard<std::mutex> lock(lock_);
+    EvictExpiredLocked();
+    if (parked_.size() >= kMaxParked) {
+      munmap(parked_.front().base, parked_.front().size);
+      parked_.pop_front();
+    }
+    parked_.push_back({st.st_dev, st.st_ino, base, size, std::chrono::steady_clock::now()});
+    StartReaperLocked();
+  }
+
+  void GetStats(MetadataMapStats *stats) {
+    std::lock_guard<std::mutex> lock(lock_);
+    EvictExpiredLocked();
+    *stats = stats_;
+    stats->parked = UINT(parked_.size());
+  }
+
+ private:
+  struct ParkedMapping {
+    dev_t dev;
+    ino_t ino;
+    void *base;
+    uint64_t size;
+    std::chrono::steady_clock::time_point parked_at;
+  };
+
+  void EvictExpiredLocked() {
+    auto now = std::chrono::steady_clock::now();
+    while (!parked_.empty() && (now - parked_.front().parked_at) >= kParkedTimeout) {
+      munmap(parked_.front().base, parked_.front().size);
+      parked_.pop_front();
+    }
+  }
+
+  void StartReaperLocked() {
+    if (reaper_running_) {
+      return;
+    }
+    pthread_attr_t attr;
+    pthread_t thread;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    // On failure, parked mappings still expire from the next Take, Park or GetStats.
+    if (pthread_create(&thread, &attr, &MetadataMapCache::Reap, this) == 0) {
+      reaper_running_ = true;
+    } else {
+      ALOGW("%s: failed to start metadata map reaper", __func__);
+    }
+    pthread_attr_destroy(&attr);
+  }
+
+  static void *Reap(void *arg) {
+    MetadataMapCache *cache = reinterpret_cast<MetadataMapCache *>(arg);
+    std::unique_lock<std::mutex> lock(cache->lock_);
+    while (!cache->parked_.empty()) {
+      auto deadline = cache->parked_.front().parked_at + kParkedTimeout;
+      lock.unlock();
+      std::this_thread::sleep_until(deadline);
+      lock.lock();
+      cache->EvictExpiredLocked();
+    }
+    cache->reaper_running_ = false;
+
+    return nullptr;
+  }
+
+  static constexpr size_t kMaxParked = 64;
+  static constexpr std::chrono::milliseconds kParkedTimeout{500};
+  std::mutex lock_;
+  std::deque<ParkedMapping> parked_;
+  MetadataMapStats stats_;
+  bool reaper_running_ = false;
+};
+
+// Never destroyed, handles may still be unmapped from other static destructors
+static MetadataMapCache &GetMetadataMapCache() {
+  static MetadataMapCache *cache = new MetadataMapCache();
+  return *cache;
+}
+
+void GetMetadataMapStats(MetadataMapStats *stats) {
+  GetMetadataMapCache().GetStats(stats);
+}
+
 void UnmapAndReset(private_handle_t *handle) {
-  uint64_t reserved_region_size = handle->reserved_size;
   if (private_handle_t::validate(handle) == 0 && handle->base_metadata) {
-    munmap(reinterpret_cast<void *>(handle->base_metadata),
-           GetMetaDataSize(reserved_region_size, handle->custom_content_md_reserved_size));
+    uint64_t reserved_region_size = handle->reserved_size;
+    GetMetadataMapCache().Park(handle->fd_metadata,
+                               reinterpret_cast<void *>(handle->base_metadata),
+                               GetMetaDataSize(reserved_region_size,
+                                               handle->custom_content_md_reserved_size));
     handle->base_metadata = 0;
   }
 }
@@ -2218,11 +2343,14 @@ int ValidateAndMap(private_handle_t *handle) {
   if (!handle->base_metadata) {
     uint64_t reserved_region_size = handle->reserved_size;
     uint64_t size = GetMetaDataSize(reserved_region_size, handle->custom_content_md_reserved_size);
-    void *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, handle->fd_metadata, 0);
-    if (base == reinterpret_cast<void *>(MAP_FAILED)) {
-      ALOGE("%s: metadata mmap failed - handle:%p fd: %d err: %s", __func__, handle,
-            handle->fd_metadata, strerror(errno));
-      return -1;
+    void *base = GetMetadataMapCache().Take(handle->fd_metadata, size);
+    if (!base) {
+      base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, handle->fd_metadata, 0);
+      if (base == reinterpret_cast<void *>(MAP_FAILED)) {
+        ALOGE("%s: metadata mmap failed - handle:%p fd: %d err: %s", __func__, handle,
+              handle->fd_metadata, strerror(errno));
+        return -1;
+      }
     }
     handle->base_metadata = (uintptr_t)base;
   }
@@ -163,6 +163,12 @@ enum {
   LAYOUT_INTERLACED_FLAG = 1 << 0,
 };
 
+struct MetadataMapStats {
+  uint64_t hits = 0;    // Mappings reused from the parked set
+  uint64_t misses = 0;  // Mappings created with mmap
+  uint32_t parked = 0;  // Unmapped regions currently held for reuse
+};
+
 struct PlaneLayoutInfo {
   /** Components represented the type of plane. */
   PlaneComponent component;
@@ -267,8 +273,10 @@ uint64_t GetCustomContentMetadataSize(int format, uint64_t usage);
 uint64_t GetMetaDataSize(uint64_t reserved_region_size, uint64_t custom_content_md_region_size = 0);
 void UnmapAndReset(private_handle_t *handle);
 int ValidateAndMap(private_handle_t *handle);
+void GetMetadataMapStats(MetadataMapStats *stats);
 Error GetColorSpaceFromColorMetaData(ColorMetaData color_metadata, uint32_t *color_space);
 Error GetMetaDataByReference(void *buffer, int64_t type, void **out);
+bool getGralloc4Array(MetaData_t *metadata, int64_t paramType);
 Error GetMetaDataValue(void *buffer, int64_t type, void *in);
 Error GetMetaDataInternal(void *buffer, int64_t type, void *in, void **out);
 Error ColorMetadataToDataspace(ColorMetaData color_metadata,
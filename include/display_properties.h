@@ -136,6 +136,16 @@
 #define FORCE_TONEMAPPING                    DISPLAY_PROP("force_tonemapping")
 // Allows color management(tonemapping) in native mode (native mode is considered BT709+sRGB)
 #define ALLOW_TONEMAP_NATIVE                 DISPLAY_PROP("allow_tonemap_native")
+// Disable skipping of TEST_ONLY commits for previously validated configurations
+#define DISABLE_VALIDATE_CACHE_PROP          DISPLAY_PROP("disable_validate_cache")
+// Replay composition strategies of recently committed layer stacks with identical geometry
+#define ENABLE_STRATEGY_MEMO_PROP            DISPLAY_PROP("enable_strategy_memo")
+// Validate independent displays of a command batch concurrently on per-display worker threads
+#define ENABLE_PARALLEL_VALIDATE_PROP        DISPLAY_PROP("enable_parallel_validate")
+// Create the secondary builtin displays concurrently once their client indices are known
+#define ENABLE_PARALLEL_DISPLAY_INIT_PROP    DISPLAY_PROP("enable_parallel_display_init")
+// Probe the rotator on every start instead of reusing the capabilities cached for this kernel
+#define DISABLE_HW_CAPS_CACHE_PROP           DISPLAY_PROP("disable_hw_caps_cache")
 
 // RC
 #define ENABLE_ROUNDED_CORNER                DISPLAY_PROP("enable_rounded_corner")
@@ -220,6 +230,10 @@
 #define PRIORITIZE_CLIENT_CWB                DISPLAY_PROP("prioritize_client_cwb")
 #define TRANSIENT_FPS_CYCLE_COUNT            DISPLAY_PROP("transient_fps_cycle_count")
 #define FORCE_LM_TO_FB_CONFIG                DISPLAY_PROP("force_lm_to_fb_config")
+#define ENABLE_CONTENT_FPS_DETECTION_PROP    DISPLAY_PROP("enable_content_fps_detection")
+// Period after which a content frame rate vote met by the panel is dropped to measure again,
+// 2000 ms by default
+#define CONTENT_FPS_REPROBE_MS_PROP          DISPLAY_PROP("content_fps_reprobe_ms")
 
 // Add all other.properties above
 // End of property
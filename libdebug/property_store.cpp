@@ -0,0 +1,146 @@
+/*
+* Copyright (c) 2024 The Linux Foundation. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of The Linux Foundation nor the names of its
+*       contributors may be used to endorse or promote products derived
+*       from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+* OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+* IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <algorithm>
+
+#include "property_store.h"
+
+namespace display {
+
+int FilePropertyBackend::Read(const char *property_name, char *value) {
+  FILE *file = fopen(path_.c_str(), "r");
+  if (!file) {
+    return -1;
+  }
+
+  int length = -1;
+  size_t name_length = strlen(property_name);
+  char line[512];
+  while (fgets(line, sizeof(line), file)) {
+    if (strncmp(line, property_name, name_length) || line[name_length] != '=') {
+      continue;
+    }
+
+    const char *start = line + name_length + 1;
+    size_t count = strcspn(start, "\r\n");
+    count = (count < PropertyStore::kValueMax) ? count : (PropertyStore::kValueMax - 1);
+    memcpy(value, start, count);
+    value[count] = '\0';
+    length = static_cast<int>(count);
+  }
+
+  fclose(file);
+  return length;
+}
+
+uint32_t FilePropertyBackend::Serial() {
+  struct stat file_stat = {};
+  if (stat(path_.c_str(), &file_stat)) {
+    return 0;
+  }
+
+  return static_cast<uint32_t>(file_stat.st_mtim.tv_sec ^ file_stat.st_mtim.tv_nsec ^
+                               file_stat.st_size);
+}
+
+int PropertyStore::GetProperty(const char *property_name, int *value) {
+  Slot *slot = GetSlot(property_name);
+  if (!slot->valid.load(std::memory_order_acquire)) {
+    return -1;
+  }
+
+  *value = slot->int_value.load(std::memory_order_relaxed);
+  return 0;
+}
+
+int PropertyStore::GetProperty(const char *property_name, char *value) {
+  Slot *slot = GetSlot(property_name);
+  if (!slot->valid.load(std::memory_order_acquire)) {
+    return -1;
+  }
+
+  std::shared_ptr<const std::string> slot_value = std::atomic_load(&slot->value);
+  size_t count = std::min(slot_value->size(), static_cast<size_t>(kValueMax - 1));
+  memcpy(value, slot_value->c_str(), count);
+  value[count] = '\0';
+  return 0;
+}
+
+PropertyStore::Slot *PropertyStore::GetSlot(const char *property_name) {
+  uint32_t serial = backend_->Serial();
+  if (serial != serial_.load(std::memory_order_acquire)) {
+    // Some property changed. Re-read every known key once, other threads keep reading the
+    // previous values meanwhile.
+    std::lock_guard<std::mutex> refresh_lock(refresh_mutex_);
+    if (serial != serial_.load(std::memory_order_relaxed)) {
+      std::shared_lock<std::shared_mutex> lock(slots_mutex_);
+      for (auto &slot : slots_) {
+        Load(slot.first, slot.second.get());
+      }
+      serial_.store(serial, std::memory_order_release);
+    }
+  }
+
+  {
+    // Keys are mostly string literals, look them up by address before hashing the name.
+    std::shared_lock<std::shared_mutex> lock(slots_mutex_);
+    auto it = literal_slots_.find(property_name);
+    if (it != literal_slots_.end() && it->second->name == property_name) {
+      return it->second;
+    }
+  }
+
+  std::unique_lock<std::shared_mutex> lock(slots_mutex_);
+  std::string name(property_name);
+  std::unique_ptr<Slot> &slot = slots_[name];
+  if (!slot) {
+    slot.reset(new Slot());
+    slot->name = name;
+    Load(name, slot.get());
+  }
+  literal_slots_[property_name] = slot.get();
+
+  return slot.get();
+}
+
+void PropertyStore::Load(const std::string &property_name, Slot *slot) {
+  char value[kValueMax] = {};
+  bool valid = (backend_->Read(property_name.c_str(), value) > 0);
+
+  slot->int_value.store(valid ? atoi(value) : 0, std::memory_order_relaxed);
+  std::atomic_store(&slot->value, std::shared_ptr<const std::string>(
+                    std::make_shared<const std::string>(value)));
+  slot->valid.store(valid, std::memory_order_release);
+}
+
+}  // namespace display
@@ -0,0 +1,97 @@
+/*
+* Copyright (c) 2024 The Linux Foundation. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of The Linux Foundation nor the names of its
+*       contributors may be used to endorse or promote products derived
+*       from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+* OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+* IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef __PROPERTY_STORE_H__
+#define __PROPERTY_STORE_H__
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace display {
+
+// Source of property values for PropertyStore.
+class PropertyBackend {
+ public:
+  virtual ~PropertyBackend() { }
+  // Copies the value of property_name, at most PropertyStore::kValueMax bytes including the
+  // terminator, into value. Returns the length of the value, 0 or less if it is not set.
+  virtual int Read(const char *property_name, char *value) = 0;
+  // Token which changes whenever any property may have changed.
+  virtual uint32_t Serial() = 0;
+};
+
+// Stand-in backend reading "name=value" lines from a file, for hosts without a property service.
+class FilePropertyBackend : public PropertyBackend {
+ public:
+  explicit FilePropertyBackend(const char *path) : path_(path) { }
+  virtual int Read(const char *property_name, char *value);
+  virtual uint32_t Serial();
+
+ private:
+  std::string path_;
+};
+
+// Caches property values per key. A key is read from the backend on first use and kept in a slot
+// which is read with atomic loads afterwards. All slots are re-read when the backend serial
+// changes, so runtime property changes are still picked up.
+class PropertyStore {
+ public:
+  static const int kValueMax = 92;  // PROPERTY_VALUE_MAX
+
+  explicit PropertyStore(PropertyBackend *backend) : backend_(backend) { }
+  int GetProperty(const char *property_name, int *value);
+  int GetProperty(const char *property_name, char *value);
+
+ private:
+  struct Slot {
+    std::string name = "";
+    std::atomic<bool> valid { false };
+    std::atomic<int> int_value { 0 };
+    std::shared_ptr<const std::string> value = nullptr;
+  };
+
+  Slot *GetSlot(const char *property_name);
+  void Load(const std::string &property_name, Slot *slot);
+
+  PropertyBackend *backend_ = nullptr;
+  std::atomic<uint32_t> serial_ { 0 };
+  std::shared_mutex slots_mutex_;
+  std::mutex refresh_mutex_;
+  std::unordered_map<std::string, std::unique_ptr<Slot>> slots_;
+  std::unordered_map<const char *, Slot *> literal_slots_;
+};
+
+}  // namespace display
+
+#endif  // __PROPERTY_STORE_H__
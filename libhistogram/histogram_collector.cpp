@@ -28,6 +28,7 @@
 #include <fstream>
 #include <iomanip>
 #include <memory>
+#include <numeric>
 #include <sstream>
 #include <tuple>
 #include <unordered_map>
@@ -59,9 +60,10 @@ static constexpr int bucket_compression = HIST_V_SIZE / numBuckets;
 std::array<uint64_t, numBuckets> rebucketTo8Buckets(
     std::array<uint64_t, HIST_V_SIZE> const &frame) {
   std::array<uint64_t, numBuckets> bins;
-  bins.fill(0);
-  for (auto i = 0u; i < HIST_V_SIZE; i++)
-    bins[i / bucket_compression] += frame[i];
+  for (auto bucket = 0u; bucket < numBuckets; bucket++) {
+    auto const first = frame.begin() + bucket * bucket_compression;
+    bins[bucket] = std::accumulate(first, first + bucket_compression, uint64_t(0));
+  }
   return bins;
 }
 }  // namespace
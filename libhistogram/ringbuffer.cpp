@@ -17,7 +17,8 @@
 #include <log/log.h>
 #include <unistd.h>
 #include <algorithm>
-#include <iostream>
+#include <chrono>
+#include <limits>
 
 #include "ringbuffer.h"
 
@@ -28,8 +29,20 @@ nsecs_t histogram::DefaultTimeKeeper::current_time() const {
 histogram::Ringbuffer::Ringbuffer(size_t ringbuffer_size, std::unique_ptr<histogram::TimeKeeper> tk)
     : rb_max_size(ringbuffer_size), timekeeper(std::move(tk)), cumulative_frame_count(0) {
   cumulative_bins.fill(0);
+  completed_bins.fill(0);
 }
 
+namespace {
+void accumulate_weighted(drm_msm_hist const &histogram, nsecs_t time_displayed,
+                         std::array<uint64_t, HIST_V_SIZE> &bins) {
+  uint64_t const weight = std::chrono::duration_cast<std::chrono::milliseconds>(
+                              std::chrono::nanoseconds(time_displayed)).count();
+  for (auto i = 0u; i < HIST_V_SIZE; i++) {
+    bins[i] += histogram.data[i] * weight;
+  }
+}
+}  // namespace
+
 std::unique_ptr<histogram::Ringbuffer> histogram::Ringbuffer::create(
     size_t ringbuffer_size, std::unique_ptr<histogram::TimeKeeper> tk) {
   if ((ringbuffer_size == 0) || !tk)
@@ -44,13 +57,11 @@ void histogram::Ringbuffer::update_cumulative(nsecs_t now, uint64_t &count,
     return;
 
   count++;
-  ALOGI("count : %llu", static_cast<unsigned long long>(count));
 
   const auto delta = std::chrono::duration_cast<std::chrono::milliseconds>(
       std::chrono::nanoseconds(now - ringbuffer.front().start_timestamp));
 
   for (auto i = 0u; i < bins.size(); i++) {
-    ALOGI("histogram.data[%d]: %u\n", i, ringbuffer.front().histogram.data[i]);
     auto const increment = ringbuffer.front().histogram.data[i] * delta.count();
     if (CC_UNLIKELY((bins[i] + increment < bins[i]) ||
                     (increment < ringbuffer.front().histogram.data[i]))) {
@@ -58,26 +69,29 @@ void histogram::Ringbuffer::update_cumulative(nsecs_t now, uint64_t &count,
     } else {
       bins[i] += increment;
     }
-    ALOGI("bins[%d]: %llu\n", i, static_cast<unsigned long long>(bins[i]));
   }
 }
 
 void histogram::Ringbuffer::insert(drm_msm_hist const &frame) {
-  std::cout << "Enter insert ringbuffer" << std::endl;
-
   std::unique_lock<decltype(mutex)> lk(mutex);
   auto now = timekeeper->current_time();
 
-  std::cout << "update cumulative count" << std::endl;
   update_cumulative(now, cumulative_frame_count, cumulative_bins);
 
+  if (!ringbuffer.empty()) {
+    auto &front = ringbuffer.front();
+    front.end_timestamp = now;
+    if (completed_count++ % kCheckpointInterval == 0) {
+      front.completed_bins_before =
+          std::make_unique<std::array<uint64_t, HIST_V_SIZE>>(completed_bins);
+    }
+    accumulate_weighted(front.histogram, front.end_timestamp - front.start_timestamp,
+                        completed_bins);
+  }
   if (ringbuffer.size() == rb_max_size)
     ringbuffer.pop_back();
-  if (!ringbuffer.empty())
-    ringbuffer.front().end_timestamp = now;
 
-  std::cout << "Exit insert ringbuffer" << std::endl;
-  ringbuffer.push_front({frame, now, 0});
+  ringbuffer.push_front({frame, now, 0, nullptr});
 }
 
 bool histogram::Ringbuffer::resize(size_t ringbuffer_size) {
@@ -118,6 +132,11 @@ histogram::Ringbuffer::Sample histogram::Ringbuffer::collect_max_after(nsecs_t t
   return collect_max_after(timestamp, max_frames, lk);
 }
 
+uint64_t histogram::Ringbuffer::collect_walk_count() const {
+  std::unique_lock<decltype(mutex)> lk(mutex);
+  return walk_count;
+}
+
 histogram::Ringbuffer::Sample histogram::Ringbuffer::collect_max(
     uint32_t max_frames, std::unique_lock<std::mutex> const &) const {
   auto collect_first = std::min(static_cast<size_t>(max_frames), ringbuffer.size());
@@ -125,16 +144,23 @@ histogram::Ringbuffer::Sample histogram::Ringbuffer::collect_max(
     return {0, {}};
   std::array<uint64_t, HIST_V_SIZE> bins;
   bins.fill(0);
-  for (auto it = ringbuffer.begin(); it != ringbuffer.end() &&
-    it != ringbuffer.begin() + collect_first; it++) {
-    nsecs_t end_timestamp = it->end_timestamp;
-    if (it == ringbuffer.begin()) {
-      end_timestamp = timekeeper->current_time();
-    }
-    const auto time_displayed = std::chrono::nanoseconds(end_timestamp - it->start_timestamp);
-    const auto delta = std::chrono::duration_cast<std::chrono::milliseconds>(time_displayed);
+
+  // The newest entry is still being displayed, weight it up to now.
+  auto const &front = ringbuffer.front();
+  accumulate_weighted(front.histogram, timekeeper->current_time() - front.start_timestamp, bins);
+
+  // Sum the completed entries from the oldest collected one up to the next newer checkpoint. The
+  // entries from that checkpoint on are everything that got added to completed_bins since it.
+  auto index = collect_first - 1;
+  for (; (index > 0) && !ringbuffer[index].completed_bins_before; index--) {
+    auto const &entry = ringbuffer[index];
+    accumulate_weighted(entry.histogram, entry.end_timestamp - entry.start_timestamp, bins);
+    walk_count++;
+  }
+  if (index > 0) {
+    auto const &checkpoint = *ringbuffer[index].completed_bins_before;
     for (auto i = 0u; i < HIST_V_SIZE; i++) {
-      bins[i] += it->histogram.data[i] * delta.count();
+      bins[i] += completed_bins[i] - checkpoint[i];
     }
   }
   return {collect_first, bins};
@@ -143,8 +169,8 @@ histogram::Ringbuffer::Sample histogram::Ringbuffer::collect_max(
 histogram::Ringbuffer::Sample histogram::Ringbuffer::collect_max_after(
     nsecs_t timestamp, uint32_t max_frames, std::unique_lock<std::mutex> const &lk) const {
   auto ts_filter_begin = std::lower_bound(
-      ringbuffer.begin(), ringbuffer.end(), HistogramEntry{{}, timestamp, 0},
-      [](auto const &a, auto const &b) { return a.start_timestamp >= b.start_timestamp; });
+      ringbuffer.begin(), ringbuffer.end(), timestamp,
+      [](auto const &entry, nsecs_t ts) { return entry.start_timestamp >= ts; });
 
   auto collect_last = std::min(std::distance(ringbuffer.begin(), ts_filter_begin),
                                static_cast<std::ptrdiff_t>(max_frames));
@@ -56,8 +56,15 @@ class Ringbuffer {
   Sample collect_after(nsecs_t timestamp) const;
   Sample collect_max(uint32_t max_frames) const;
   Sample collect_max_after(nsecs_t timestamp, uint32_t max_frames) const;
+  // number of entries whose bins were summed one by one by the collections so far. A collection
+  // walks fewer than kCheckpointInterval entries, whatever the size of the ringbuffer.
+  uint64_t collect_walk_count() const;
   ~Ringbuffer() = default;
 
+  // every kCheckpointInterval-th completed entry keeps a copy of completed_bins (2KB), so the
+  // per entry footprint stays around sizeof(drm_msm_hist) instead of doubling it.
+  static constexpr uint64_t kCheckpointInterval = 16;
+
  private:
   Ringbuffer(size_t ringbuffer_size, std::unique_ptr<TimeKeeper> tk);
   Ringbuffer(Ringbuffer const &) = delete;
@@ -74,6 +81,9 @@ class Ringbuffer {
     drm_msm_hist histogram;
     nsecs_t start_timestamp;
     nsecs_t end_timestamp;
+    // value of completed_bins just before this entry's own weighted bins were added to it, only
+    // set on checkpoint entries.
+    std::unique_ptr<std::array<uint64_t, HIST_V_SIZE>> completed_bins_before;
   };
   std::deque<HistogramEntry> ringbuffer;
   size_t rb_max_size;
@@ -81,6 +91,11 @@ class Ringbuffer {
 
   uint64_t cumulative_frame_count;
   std::array<uint64_t, HIST_V_SIZE> cumulative_bins;
+  // running (modulo 2^64) sum of the time-weighted bins of every entry that has stopped being
+  // displayed. The weighted bins of any run of completed entries is a difference of two values.
+  std::array<uint64_t, HIST_V_SIZE> completed_bins;
+  uint64_t completed_count = 0;
+  uint64_t mutable walk_count = 0;
 };
 
 }  // namespace histogram
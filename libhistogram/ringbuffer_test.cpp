@@ -15,6 +15,7 @@
  */
 
 #include <chrono>
+#include <deque>
 #include <numeric>
 
 #include <gmock/gmock.h>
@@ -407,6 +408,105 @@ TEST_F(RingbufferTestCases, TimeWeightingTest) {
   }
 }
 
+TEST_F(RingbufferTestCases, IncrementalAggregatesMatchFullWalk) {
+  static constexpr size_t ringbuffer_size = 17u;
+  static constexpr size_t numInsertions = 100u;
+  auto tk = std::make_shared<TickingTimeKeeper>();
+  auto rb = histogram::Ringbuffer::create(ringbuffer_size, std::make_unique<TimeKeeperWrapper>(tk));
+
+  // Newest first, like the ringbuffer: the frame and how long it has been displayed.
+  std::deque<std::tuple<drm_msm_hist, std::chrono::nanoseconds>> frames;
+  auto expected = [&frames](size_t max_frames) {
+    std::array<uint64_t, HIST_V_SIZE> expected_bins;
+    expected_bins.fill(0);
+    for (auto i = 0u; i < std::min(max_frames, frames.size()); i++) {
+      for (auto j = 0u; j < HIST_V_SIZE; j++) {
+        expected_bins[j] += std::get<0>(frames[i]).data[j] * toMs(std::get<1>(frames[i]));
+      }
+    }
+    return expected_bins;
+  };
+
+  for (auto n = 0u; n < numInsertions; n++) {
+    drm_msm_hist frame {};
+    for (auto i = 0u; i < HIST_V_SIZE; i++) {
+      frame.data[i] = (n * 7919u + i * 104729u) % 65536u;
+    }
+    rb->insert(frame);
+    frames.push_front({frame, 0ns});
+    if (frames.size() > ringbuffer_size) {
+      frames.pop_back();
+    }
+
+    // Uneven display times, including partial milliseconds which are truncated per frame.
+    auto const displayed = std::chrono::microseconds(500 + (n * 1237u) % 20000u);
+    tk->increment_by(displayed);
+    std::get<1>(frames.front()) = displayed;
+
+    for (auto max_frames : {1u, 2u, 5u, 16u, 17u, 100u}) {
+      std::tie(numFrames, bins) = rb->collect_max(max_frames);
+      EXPECT_THAT(numFrames, Eq(std::min(static_cast<size_t>(max_frames), frames.size())));
+      EXPECT_THAT(bins, ElementsAreArray(expected(max_frames)));
+    }
+
+    if (n == numInsertions / 2) {
+      ASSERT_TRUE(rb->resize(ringbuffer_size / 2));
+      frames.resize(ringbuffer_size / 2);
+      std::tie(numFrames, bins) = rb->collect_ringbuffer_all();
+      EXPECT_THAT(bins, ElementsAreArray(expected(frames.size())));
+      ASSERT_TRUE(rb->resize(ringbuffer_size));
+    }
+  }
+}
+
+TEST_F(RingbufferTestCases, LargeRingbufferCollection) {
+  static constexpr size_t ringbuffer_size = 10000u;
+  static constexpr size_t numQueries = 10000u;
+  auto tk = std::make_shared<TickingTimeKeeper>();
+  auto rb = histogram::Ringbuffer::create(ringbuffer_size, std::make_unique<TimeKeeperWrapper>(tk));
+
+  for (auto n = 0u; n < 2 * ringbuffer_size; n++) {
+    insertFrameIncrementTimeline(*rb, *tk, (n % 2) ? frame1 : frame0);
+  }
+
+  // Repeated whole-ring queries must keep returning the same totals.
+  for (auto n = 0u; n < numQueries; n++) {
+    std::tie(numFrames, bins) = rb->collect_ringbuffer_all();
+  }
+
+  EXPECT_THAT(numFrames, Eq(ringbuffer_size));
+  EXPECT_THAT(bins, Each((fill_frame0 + fill_frame1) * ringbuffer_size / 2));
+
+  // Each whole-ring query only sums the entries before the oldest checkpoint one by one.
+  EXPECT_THAT(rb->collect_walk_count(),
+              Lt(numQueries * histogram::Ringbuffer::kCheckpointInterval));
+
+  std::tie(numFrames, bins) = rb->collect_after(toNsecs(2 * ringbuffer_size * 1ms - 3ms));
+  EXPECT_THAT(numFrames, Eq(3));
+  EXPECT_THAT(bins, Each(fill_frame1 + fill_frame0 + fill_frame1));
+}
+
+TEST_F(RingbufferTestCases, CollectionWalksBoundedByCheckpointInterval) {
+  static constexpr size_t ringbuffer_size = 1000u;
+  auto tk = std::make_shared<TickingTimeKeeper>();
+  auto rb = histogram::Ringbuffer::create(ringbuffer_size, std::make_unique<TimeKeeperWrapper>(tk));
+
+  for (auto n = 0u; n < ringbuffer_size + 7; n++) {
+    insertFrameIncrementTimeline(*rb, *tk, (n % 2) ? frame1 : frame0);
+  }
+
+  for (auto max_frames = 1u; max_frames <= ringbuffer_size; max_frames++) {
+    auto const walked_before = rb->collect_walk_count();
+    std::tie(numFrames, bins) = rb->collect_max(max_frames);
+    EXPECT_THAT(rb->collect_walk_count() - walked_before,
+                Lt(histogram::Ringbuffer::kCheckpointInterval));
+    auto const completed = max_frames - 1;
+    auto const expected = fill_frame0 * (completed / 2) + fill_frame1 * ((completed + 1) / 2) +
+                          ((ringbuffer_size + 6) % 2 ? fill_frame1 : fill_frame0);
+    EXPECT_THAT(bins, Each(expected)) << "max_frames " << max_frames;
+  }
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -39,7 +39,10 @@
 #include <string.h>
 #include <sys/mman.h>
 
+#include <algorithm>
 #include <cinttypes>
+#include <cstddef>
+#include <vector>
 
 static int colorMetaDataToColorSpace(ColorMetaData in, ColorSpace_t *out) {
   if (in.colorPrimaries == ColorPrimaries_BT601_6_525 ||
@@ -571,6 +574,64 @@ int getMetaDataVa(MetaData_t *data, DispFetchParamType paramType,
     return ret;
 }
 
+struct MetaDataPayload {
+  size_t offset;
+  size_t size;
+  DispParamType paramType;
+};
+
+// Bulk payloads are only meaningful while their metadata key is set, so copies skip them
+// when the key is set on neither side. Sorted by offset to copy the remaining fields in as few runs as possible.
+static const std::vector<MetaDataPayload> &getMetaDataPayloads() {
+  static const std::vector<MetaDataPayload> payloads = [] {
+    std::vector<MetaDataPayload> p = {
+        {offsetof(MetaData_t, graphics_metadata.data),
+         sizeof(MetaData_t::graphics_metadata.data), SET_GRAPHICS_METADATA},
+        {offsetof(MetaData_t, cvpMetadata.payload), sizeof(MetaData_t::cvpMetadata.payload),
+         SET_CVP_METADATA},
+        {offsetof(MetaData_t, video_histogram_stats.stats_info),
+         sizeof(MetaData_t::video_histogram_stats.stats_info), SET_VIDEO_HISTOGRAM_STATS},
+    };
+    std::sort(p.begin(), p.end(), [](const MetaDataPayload &a, const MetaDataPayload &b) {
+      return a.offset < b.offset;
+    });
+    return p;
+  }();
+  return payloads;
+}
+
+// TODO(user): Copies and setMetaData still race with a writer in another process, and a copy
+// moves every field except the unset payloads. Per section generation counters (seqlock) and a
+// layout version need new fields in MetaData_t, which is shared ABI defined outside this library.
+static void copyMetaDataSections(const MetaData_t *src_data, MetaData_t *dst_data) {
+  if (src_data == dst_data) {
+    return;
+  }
+
+  // A payload may only be skipped when neither side has its key set; otherwise the destination
+  // would keep a payload its (now copied) status says nothing about. Sample the destination
+  // status up front, since the status arrays are overwritten by the copy below.
+  auto &payloads = getMetaDataPayloads();
+  std::vector<bool> skip(payloads.size());
+  for (size_t i = 0; i < payloads.size(); i++) {
+    skip[i] = !getGralloc4Array(const_cast<MetaData_t *>(src_data), payloads[i].paramType) &&
+              !getGralloc4Array(dst_data, payloads[i].paramType);
+  }
+
+  auto src = reinterpret_cast<const uint8_t *>(src_data);
+  auto dst = reinterpret_cast<uint8_t *>(dst_data);
+  size_t offset = 0;
+  for (size_t i = 0; i < payloads.size(); i++) {
+    auto &payload = payloads[i];
+    if (!skip[i]) {
+      continue;
+    }
+    memcpy(dst + offset, src + offset, payload.offset - offset);
+    offset = payload.offset + payload.size;
+  }
+  memcpy(dst + offset, src + offset, sizeof(MetaData_t) - offset);
+}
+
 int copyMetaData(struct private_handle_t *src, struct private_handle_t *dst) {
     auto err = validateAndMap(src);
     if (err != 0)
@@ -582,7 +643,7 @@ int copyMetaData(struct private_handle_t *src, struct private_handle_t *dst) {
 
     MetaData_t *src_data = reinterpret_cast <MetaData_t *>(src->base_metadata);
     MetaData_t *dst_data = reinterpret_cast <MetaData_t *>(dst->base_metadata);
-    *dst_data = *src_data;
+    copyMetaDataSections(src_data, dst_data);
     return 0;
 }
 
@@ -596,7 +657,7 @@ int copyMetaDataVaToHandle(MetaData_t *src_data, struct private_handle_t *dst) {
         return err;
 
     MetaData_t *dst_data = reinterpret_cast <MetaData_t *>(dst->base_metadata);
-    *dst_data = *src_data;
+    copyMetaDataSections(src_data, dst_data);
     return 0;
 }
 
@@ -610,7 +671,7 @@ int copyMetaDataHandleToVa(struct private_handle_t *src, MetaData_t *dst_data) {
         return err;
 
     MetaData_t *src_data = reinterpret_cast <MetaData_t *>(src->base_metadata);
-    *dst_data = *src_data;
+    copyMetaDataSections(src_data, dst_data);
     return 0;
 }
 
@@ -622,7 +683,7 @@ int copyMetaDataVaToVa(MetaData_t *src_data, MetaData_t *dst_data) {
     if (dst_data == nullptr)
         return err;
 
-    *dst_data = *src_data;
+    copyMetaDataSections(src_data, dst_data);
     return 0;
 }
 
@@ -87,6 +87,11 @@ static uint8_t VM_REQ_STATE_NONE = 0;
 static uint8_t VM_REQ_STATE_RELEASE = 1;
 static uint8_t VM_REQ_STATE_ACQUIRE = 2;
 
+// Parsed CRTC capabilities, keyed on the blob text. Every CRTC exposes the same blob, so it is
+// parsed once per process.
+static mutex parsed_caps_lock;
+static map<string, DRMCrtcInfo> parsed_caps;
+
 static void PopulateSecurityLevels(drmModePropertyRes *prop) {
   static bool security_levels_populated = false;
   if (!security_levels_populated) {
@@ -408,6 +413,19 @@ void DRMCrtc::ParseCapabilities(uint64_t blob_id) {
   char *fmt_str = new char[blob->length + 1];
   memcpy (fmt_str, blob->data, blob->length);
   fmt_str[blob->length] = '\0';
+  string caps(fmt_str);
+
+  {
+    lock_guard<mutex> lock(parsed_caps_lock);
+    auto it = parsed_caps.find(caps);
+    if (it != parsed_caps.end()) {
+      ApplyParsedCapabilities(it->second);
+      drmModeFreePropertyBlob(blob);
+      delete[] fmt_str;
+      return;
+    }
+  }
+
   stringstream stream(fmt_str);
   DRM_LOGI("stream str %s len %zu blob str %s len %d", stream.str().c_str(), stream.str().length(),
            blob->data, blob->length);
@@ -600,10 +618,26 @@ void DRMCrtc::ParseCapabilities(uint64_t blob_id) {
         }
     }
   }
+  {
+    lock_guard<mutex> lock(parsed_caps_lock);
+    parsed_caps.emplace(std::move(caps), crtc_info_);
+  }
   drmModeFreePropertyBlob(blob);
   delete[] fmt_str;
 }
 
+void DRMCrtc::ApplyParsedCapabilities(const DRMCrtcInfo &parsed) {
+  // Noise layer and writeback support come from this CRTC's properties, not from the blob.
+  bool has_noise_layer = crtc_info_.has_noise_layer;
+  bool concurrent_writeback = crtc_info_.concurrent_writeback;
+  std::vector<DRMCWbCaptureMode> tap_points = std::move(crtc_info_.tap_points);
+
+  crtc_info_ = parsed;
+  crtc_info_.has_noise_layer = has_noise_layer;
+  crtc_info_.concurrent_writeback = concurrent_writeback;
+  crtc_info_.tap_points = std::move(tap_points);
+}
+
 void DRMCrtc::ParseCompRatio(string line, bool real_time) {
   CompRatioMap &comp_ratio_map =
     real_time ? crtc_info_.comp_ratio_rt_map : crtc_info_.comp_ratio_nrt_map;
@@ -126,6 +126,31 @@ struct BufferInfo {
   void *private_data = NULL;              //!< Pointer to private data.
 };
 
+/*! @brief Current layout version of BufferDescriptorInfo.
+
+  @sa BufferDescriptorInfo
+*/
+const uint32_t kBufferDescriptorVersion = 1;
+
+/*! @brief Holds the properties of an allocated buffer handle, gathered in a single query.
+
+  @sa BufferAllocator::GetBufferDescriptor
+*/
+struct BufferDescriptorInfo {
+  uint32_t version = kBufferDescriptorVersion;  //!< Layout version filled by the allocator.
+  int fd = -1;                             //!< Specifies the fd of the buffer.
+  uint32_t width = 0;                      //!< Specifies aligned buffer width in pixels.
+  uint32_t height = 0;                     //!< Specifies aligned buffer height in pixels.
+  uint32_t unaligned_width = 0;            //!< Specifies requested buffer width in pixels.
+  uint32_t unaligned_height = 0;           //!< Specifies requested buffer height in pixels.
+  uint32_t alloc_size = 0;                 //!< Specifies the size of the allocation.
+  uint64_t id = 0;                         //!< Specifies the Id of the buffer.
+  int32_t format = 0;                      //!< Specifies the requested pixel format.
+  int32_t private_flags = 0;               //!< Specifies the allocator private flags.
+  LayerBufferFormat sdm_format = kFormatInvalid;  //!< Specifies the SDM format of the buffer.
+  uint32_t buffer_type = 0;                //!< Specifies the buffer type.
+};
+
 /*! @brief Buffer allocator implemented by the client
 
   @details This class declares prototype for BufferAllocator methods which must be
@@ -201,6 +226,22 @@ class BufferAllocator {
     (void) num_planes;
     return -ENOTSUP; }
 
+  /*! @brief Method to get the properties of an allocated buffer in one query.
+
+    @details This method validates the handle once and fills all the properties fixed at
+    allocation, which are otherwise available through individual getters.
+
+    @param[in] buf Handle of the allocated buffer
+
+    @param[out] info \link BufferDescriptorInfo \endlink
+
+    @return \link int \endlink
+  */
+  virtual int GetBufferDescriptor(void *buf, BufferDescriptorInfo *info) {
+    (void) buf;
+    (void) info;
+    return -ENOTSUP; }
+
  protected:
   virtual ~BufferAllocator() { }
 };
@@ -244,6 +244,11 @@ struct LayerFlags {
       uint32_t skip_iwe : 1;
                               //!< This flag shall be set to indicate that this layer
                               //!< is handled by IWE for two phase composition.
+      uint32_t buffer_updated : 1;
+                              //!< This flag shall be set by client to indicate that a new buffer
+                              //!< was set on this layer since the previous commit. Together with
+                              //!< geometry_changes and update_mask it tells which attributes of
+                              //!< the layer are dirty.
     };
 
     uint32_t flags = 0;       //!< For initialization purpose only.
@@ -470,6 +475,9 @@ struct Layer {
   uint32_t frame_rate = 0;                         //!< Rate at which frames are being updated for
                                                    //!< this layer.
 
+  uint32_t content_frame_rate = 0;                 //!< Rate at which the layer content is measured
+                                                   //!< to update, 0 when it is not stable.
+
   uint32_t solid_fill_color = 0;                   //!< TODO: Remove this field when fb support
                                                    //!  is deprecated.
                                                    //!< Solid color used to fill the layer when
@@ -185,6 +185,8 @@ class HWInterface {
   virtual DisplayError UpdateTransferTime(uint32_t transfer_time) = 0;
   virtual DisplayError CancelDeferredPowerMode() = 0;
   virtual void HandleCwbTeardown() = 0;
+  // State programmed on the validate request which is not part of HWLayersInfo.
+  virtual DisplayError GetValidateState(uint64_t *state) = 0;
 
  protected:
   virtual ~HWInterface() { }
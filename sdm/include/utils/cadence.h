@@ -0,0 +1,59 @@
+/*
+* Copyright (c) 2024 The Linux Foundation. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of The Linux Foundation nor the names of its
+*       contributors may be used to endorse or promote products derived
+*       from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+* OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+* IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef __CADENCE_H__
+#define __CADENCE_H__
+
+#include <stdint.h>
+#include <deque>
+
+namespace sdm {
+
+// Estimates the rate at which a layer's content is updated from the timestamps of its buffer
+// changes. A sliding window of timestamps is kept and the average rate over the window is snapped
+// to a standard content rate. Averaging over the window also resolves pulldown cadences such as
+// 24 fps on a 60 Hz panel, where buffers alternate between two and three vsyncs.
+class CadenceEstimator {
+ public:
+  void AddTimestamp(int64_t timestamp_ns);
+  // Returns the detected content rate, or 0 when the cadence is not stable.
+  uint32_t GetFrameRate() const;
+  void Reset() { timestamps_.clear(); }
+
+ private:
+  static const uint32_t kMaxSamples = 48;
+  static const uint32_t kMinSamples = 24;
+  static const int64_t kMaxIntervalNs = 200000000;  // Longer gaps restart the estimate.
+
+  std::deque<int64_t> timestamps_;
+};
+
+}  // namespace sdm
+
+#endif  // __CADENCE_H__
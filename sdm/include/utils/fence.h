@@ -32,6 +32,9 @@
 
 #include <core/buffer_sync_handler.h>
 #include <unistd.h>
+#include <atomic>
+#include <functional>
+#include <future>  // NOLINT
 #include <utility>
 #include <memory>
 #include <string>
@@ -85,6 +88,17 @@ class Fence {
   static int Wait(const shared_ptr<Fence> &fence);
   static int Wait(const shared_ptr<Fence> &fence, int timeout);
 
+  // Non blocking wait through the process wide fence watcher. Callback is invoked on the watcher
+  // thread with 0 once the fence signals or -ETIME when timeout (ms) expires, and must not block.
+  // Null or already signaled fence invokes the callback in place. Callback is not invoked if an
+  // error is returned.
+  static int WaitAsync(const shared_ptr<Fence> &fence, int timeout,
+                       std::function<void(int status)> callback);
+  static std::future<int> WaitAsync(const shared_ptr<Fence> &fence, int timeout);
+
+  // CLOCK_MONOTONIC time in ns at which the fence watcher saw the fence signal, 0 if it did not.
+  static int64_t GetSignalTime(const shared_ptr<Fence> &fence);
+
   // Status check on null fence will return signaled.
   static Status GetStatus(const shared_ptr<Fence> &fence);
 
@@ -105,6 +119,9 @@ class Fence {
   static std::vector<std::weak_ptr<Fence>> wps_;
   int fd_ = -1;
   string name_ = "";
+  std::atomic<int64_t> signal_time_ns_ = {0};
+
+  friend class FenceWatcher;
 };
 
 }  // namespace sdm
@@ -0,0 +1,90 @@
+/*
+* Copyright (c) 2024 The Linux Foundation. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of The Linux Foundation nor the names of its
+*       contributors may be used to endorse or promote products derived
+*       from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+* OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+* IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef __FENCE_WATCHER_H__
+#define __FENCE_WATCHER_H__
+
+#include <stdint.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace sdm {
+
+class Fence;
+
+// Process wide watcher thread which polls sync file descriptors and notifies registered clients
+// once they signal, so that clients do not have to park a thread in a blocking wait per fence.
+// Callbacks run on the watcher thread and must not block.
+class FenceWatcher {
+ public:
+  using Callback = std::function<void(int status)>;
+
+  static FenceWatcher *Get();
+
+  // Takes ownership of fd. Callback receives 0 on signal, -ETIME on timeout and -EINVAL when the
+  // fd could not be polled. Negative timeout waits indefinitely.
+  int Register(const std::shared_ptr<Fence> &fence, int fd, int timeout_ms, Callback callback);
+  void Dump(std::ostringstream *os);
+
+ private:
+  struct Entry {
+    int fd = -1;
+    std::weak_ptr<Fence> fence;
+    Callback callback;
+    int64_t register_ns = 0;
+    int64_t deadline_ns = 0;  // 0 for no timeout.
+  };
+
+  FenceWatcher() {}
+  int Init();
+  void WatcherThread();
+  void Complete(Entry *entry, int status, int64_t now_ns);
+  static int64_t GetTimeNs();
+
+  std::mutex lock_;
+  bool initialized_ = false;
+  int epoll_fd_ = -1;
+  int wakeup_fd_ = -1;
+  uint64_t next_id_ = 1;  // id 0 is reserved for the wakeup fd.
+  std::map<uint64_t, Entry> entries_;
+  // Register to signal latency stats.
+  uint64_t signaled_count_ = 0;
+  uint64_t timeout_count_ = 0;
+  int64_t total_latency_ns_ = 0;
+  int64_t max_latency_ns_ = 0;
+};
+
+}  // namespace sdm
+
+#endif  // __FENCE_WATCHER_H__
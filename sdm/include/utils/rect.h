@@ -34,6 +34,7 @@
 #include <core/sdm_types.h>
 #include <core/layer_stack.h>
 #include <utils/debug.h>
+#include <vector>
 
 namespace sdm {
 
@@ -68,6 +69,10 @@ namespace sdm {
                                      float *dst_width, float *dst_height);
   DisplayError GetScaleFactor(const LayerRect &crop, const LayerRect &dst, bool rotate90,
                               float *scale_x, float *scale_y);
+
+  // Merges damage rects that overlap or abut into their union whenever the union covers no area
+  // outside of the inputs. Invalid and fully covered rects are dropped.
+  void CoalesceRects(const std::vector<LayerRect> &in_rects, std::vector<LayerRect> *out_rects);
 }  // namespace sdm
 
 #endif  // __RECT_H__
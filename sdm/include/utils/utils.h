@@ -69,6 +69,7 @@
 #include <utils/rect.h>
 #include <stdint.h>
 #include <cstring>
+#include <vector>
 
 namespace sdm {
 
@@ -89,6 +90,23 @@ void ApplyCwbRoiRestrictions(LayerRect &roi, const LayerRect &cwb_full_frame,
                              LayerBufferFormat format);
 const char *GetCompositionName(const LayerComposition &composition);
 
+// Mixes value into seed, used to build compact signatures of frame configurations.
+inline uint64_t HashCombine(uint64_t seed, uint64_t value) {
+  return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+// Frame configuration kept in full along with its hash. Keys are compared word by word, the hash
+// only speeds up the comparison, so configurations colliding on the hash are never mixed up.
+struct HashedKey {
+  uint64_t hash = 0;
+  std::vector<uint64_t> words = {};
+
+  void Add(uint64_t value);
+  void AddRect(const LayerRect &rect);
+  bool operator==(const HashedKey &key) const;
+  bool operator!=(const HashedKey &key) const { return !(*this == key); }
+};
+
 }  // namespace sdm
 
 #endif  // __UTILS_H__
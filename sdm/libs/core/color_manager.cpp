@@ -546,24 +546,31 @@ DisplayError ColorManagerProxy::Validate(DispLayerStack *disp_layer_stack) {
 
   bool valid_meta_data = false;
   bool update_meta_data = false;
-  Layer hdr_layer = {};
-  bool hdr_present = false;
+  Layer *hdr_layer = nullptr;
 
   valid_meta_data = NeedsToneMap(disp_layer_stack->info.hw_layers);
   if (valid_meta_data) {
     if (disp_layer_stack->info.hdr_layer_info.in_hdr_mode &&
           disp_layer_stack->info.hdr_layer_info.operation == HWHDRLayerInfo::kSet) {
-      hdr_layer = *(disp_layer_stack->stack->layers.at(
-                                 UINT32(disp_layer_stack->info.hdr_layer_info.layer_index)));
-      hdr_present = true;
+      hdr_layer = disp_layer_stack->stack->layers.at(
+                                 UINT32(disp_layer_stack->info.hdr_layer_info.layer_index));
     }
 
-    if (hdr_present && hdr_layer.input_buffer.color_metadata.dynamicMetaDataValid &&
-        hdr_layer.input_buffer.color_metadata.dynamicMetaDataLen) {
+    // Dynamic metadata travels with the buffer, it only needs to be reapplied when the HDR layer
+    // changed, got a new buffer or had its metadata updated, or when the mode assets get rebuilt.
+    bool hdr_layer_dirty = !disp_layer_stack->stack->flags.layer_id_support ||
+                           needs_update_ || apply_mode_ ||
+                           (hdr_layer && (hdr_layer->layer_id != meta_data_layer_id_ ||
+                                          hdr_layer->flags.buffer_updated ||
+                                          hdr_layer->update_mask.test(kMetadataUpdate)));
+    if (hdr_layer && hdr_layer_dirty &&
+        hdr_layer->input_buffer.color_metadata.dynamicMetaDataValid &&
+        hdr_layer->input_buffer.color_metadata.dynamicMetaDataLen) {
       update_meta_data = true;
-      meta_data_ = hdr_layer.input_buffer.color_metadata;
+      meta_data_ = hdr_layer->input_buffer.color_metadata;
     }
   }
+  meta_data_layer_id_ = hdr_layer ? hdr_layer->layer_id : 0;
 
   if (needs_update_ || apply_mode_ || update_meta_data) {
     UpdateModeHwassets(cur_mode_id_, curr_mode_, update_meta_data, meta_data_);
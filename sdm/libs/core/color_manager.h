@@ -197,6 +197,7 @@ class ColorManagerProxy {
   uint32_t cur_intent_ = 0;
   int32_t cur_mode_id_ = -1;
   ColorMetaData meta_data_ = {};
+  uint64_t meta_data_layer_id_ = 0;
   snapdragoncolor::ScPostBlendInterface *stc_intf_ = NULL;
   snapdragoncolor::ColorMode curr_mode_;
   bool needs_update_ = false;
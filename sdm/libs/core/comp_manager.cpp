@@ -203,6 +203,8 @@ DisplayError CompManager::UnregisterDisplay(Handle display_ctx) {
   callback_map_.erase(display_comp_ctx->display_id);
   registered_displays_.erase(display_comp_ctx->display_id);
   powered_on_displays_.erase(display_comp_ctx->display_id);
+  // Votes of the removed display no longer load the bus.
+  qos_updates_++;
 
   DLOGV_IF(kTagCompManager, "Registered displays [%s], display %d-%d",
            StringDisplayList(registered_displays_).c_str(), display_comp_ctx->display_id,
@@ -453,6 +455,8 @@ DisplayError CompManager::Commit(Handle display_ctx, DispLayerStack *disp_layer_
   if (error != kErrorNone) {
     return error;
   }
+
+  display_comp_ctx->strategy->CacheStrategy();
   if (secure_event_ == kTUITransitionStart) {
     return GetDefaultQosData(display_ctx, &disp_layer_stack->info.qos_data);
   }
@@ -471,6 +475,22 @@ DisplayError CompManager::PostCommit(Handle display_ctx, DispLayerStack *disp_la
     return error;
   }
 
+  const HWQosData &qos_data = disp_layer_stack->info.qos_data;
+  HWQosData &committed_qos = display_comp_ctx->committed_qos;
+  if (qos_data.clock_hz != committed_qos.clock_hz ||
+      qos_data.rot_clock_hz != committed_qos.rot_clock_hz ||
+      qos_data.core_ab_bps != committed_qos.core_ab_bps ||
+      qos_data.core_ib_bps != committed_qos.core_ib_bps ||
+      qos_data.llcc_ab_bps != committed_qos.llcc_ab_bps ||
+      qos_data.llcc_ib_bps != committed_qos.llcc_ib_bps ||
+      qos_data.dram_ab_bps != committed_qos.dram_ab_bps ||
+      qos_data.dram_ib_bps != committed_qos.dram_ib_bps ||
+      qos_data.rot_prefill_bw_bps != committed_qos.rot_prefill_bw_bps) {
+    committed_qos = qos_data;
+    display_comp_ctx->qos_updates++;
+    qos_updates_++;
+  }
+
   display_comp_ctx->idle_fallback = false;
   display_comp_ctx->first_cycle_ = false;
   display_comp_ctx->constraints.idle_timeout = false;
@@ -586,6 +606,22 @@ void CompManager::ControlPartialUpdate(Handle display_ctx, bool enable) {
   display_comp_ctx->pu_constraints.enable = enable;
 }
 
+void CompManager::GetStrategyMemoStats(Handle display_ctx, uint64_t *hits, uint64_t *misses) {
+  std::lock_guard<std::recursive_mutex> obj(comp_mgr_mutex_);
+
+  DisplayCompositionContext *display_comp_ctx =
+                             reinterpret_cast<DisplayCompositionContext *>(display_ctx);
+  display_comp_ctx->strategy->GetMemoStats(hits, misses);
+}
+
+uint64_t CompManager::GetOtherDisplaysQosUpdates(Handle display_ctx) {
+  std::lock_guard<std::recursive_mutex> obj(comp_mgr_mutex_);
+
+  DisplayCompositionContext *display_comp_ctx =
+                             reinterpret_cast<DisplayCompositionContext *>(display_ctx);
+  return qos_updates_ - display_comp_ctx->qos_updates;
+}
+
 DisplayError CompManager::ValidateScaling(const LayerRect &crop, const LayerRect &dst,
                                           bool rotate90) {
   std::lock_guard<std::recursive_mutex> obj(comp_mgr_mutex_);
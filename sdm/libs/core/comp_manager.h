@@ -85,6 +85,10 @@ class CompManager : public CwbCallback {
   void ProcessIdlePowerCollapse(Handle display_ctx);
   DisplayError SetMaxMixerStages(Handle display_ctx, uint32_t max_mixer_stages);
   void ControlPartialUpdate(Handle display_ctx, bool enable);
+  void GetStrategyMemoStats(Handle display_ctx, uint64_t *hits, uint64_t *misses);
+  // Number of bandwidth/clock vote changes committed by the other displays. The TEST_ONLY outcome
+  // of a display depends on the votes of the displays sharing the bus.
+  uint64_t GetOtherDisplaysQosUpdates(Handle display_ctx);
   DisplayError ValidateScaling(const LayerRect &crop, const LayerRect &dst, bool rotate90);
   DisplayError ValidateAndSetCursorPosition(Handle display_ctx, DispLayerStack *disp_layer_stack,
                                             int x, int y);
@@ -159,6 +163,8 @@ class CompManager : public CwbCallback {
     DisplayConfigVariableInfo fb_config = {};
     bool first_cycle_ = true;
     uint32_t dest_scaler_blocks_used = 0;
+    HWQosData committed_qos = {};
+    uint64_t qos_updates = 0;
   };
 
   std::recursive_mutex comp_mgr_mutex_;
@@ -182,6 +188,7 @@ class CompManager : public CwbCallback {
   std::map<int32_t /* display_id */, bool> display_demura_status_;
   SecureEvent secure_event_ = kSecureEventMax;
   bool high_bw_displays_present_ = false;
+  uint64_t qos_updates_ = 0;  // Vote changes committed by all displays.
 };
 
 }  // namespace sdm
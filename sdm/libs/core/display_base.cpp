@@ -228,6 +228,10 @@ DisplayError DisplayBase::Init() {
   if (Debug::Get()->GetProperty(ALLOW_TONEMAP_NATIVE, &prop) == kErrorNone) {
     allow_tonemap_native_ = (prop == 1);
   }
+  prop = 0;
+  if (Debug::Get()->GetProperty(DISABLE_VALIDATE_CACHE_PROP, &prop) == kErrorNone) {
+    disable_validate_cache_ = (prop == 1);
+  }
 
   SetupPanelFeatureFactory();
 
@@ -235,6 +239,8 @@ DisplayError DisplayBase::Init() {
   // Assume unified draw is supported.
   unified_draw_supported_ = true;
 
+  PublishInfoSnapshot();
+
   return kErrorNone;
 
 CleanupOnError:
@@ -718,6 +724,59 @@ bool DisplayBase::IsValidateNeeded() {
   return false;
 }
 
+bool DisplayBase::CanUseValidateCache() {
+  if (disable_validate_cache_ || first_cycle_ || !validated_ ||
+      (pending_power_state_ != kPowerStateNone)) {
+    return false;
+  }
+
+  // Writeback output, HDR metadata transitions and AVR updates carry one-shot state which is only
+  // programmed through a full validate.
+  HWLayersInfo &hw_layers_info = disp_layer_stack_.info;
+  if (hw_layers_info.output_buffer || hw_layers_info.hw_cwb_config ||
+      (hw_layers_info.hdr_layer_info.operation != HWHDRLayerInfo::kNoOp) ||
+      hw_layers_info.hw_avr_info.update) {
+    return false;
+  }
+
+  // Pipe LUT payloads are opaque to the validate key, frames writing one always get validated.
+  uint32_t hw_layer_count = UINT32(hw_layers_info.hw_layers.size());
+  for (uint32_t i = 0; i < hw_layer_count && i < kMaxSDELayers; i++) {
+    for (auto pipe : {&hw_layers_info.config[i].left_pipe, &hw_layers_info.config[i].right_pipe}) {
+      for (auto &lut_info : pipe->lut_info) {
+        if (lut_info.op != kNoOp) {
+          return false;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+void DisplayBase::GetValidateKey(ValidateKey *key) {
+  // Adds the display state which can change the outcome of the TEST_ONLY commit on top of the
+  // layer configuration: the other displays sharing the bandwidth, mixer, refresh and panel state.
+  HWLayersInfo &hw_layers_info = disp_layer_stack_.info;
+  key->AddLayers(hw_layers_info);
+  key->Add((UINT64(comp_manager_->GetActiveDisplayCount()) << 32) |
+           UINT32(comp_manager_->GetOtherDisplaysQosUpdates(display_comp_ctx_)));
+  key->Add((UINT64(mixer_attributes_.width) << 32) | mixer_attributes_.height);
+  key->Add((UINT64(display_attributes_.fps) << 32) | UINT32(state_));
+  key->Add((UINT64(qsync_mode_) << 32) | UINT32(hw_layers_info.hw_avr_info.mode));
+  key->Add(hw_panel_info_.transfer_time_us);
+}
+
+DisplayError DisplayBase::ValidateHW(bool use_validate_cache) {
+  if (!use_validate_cache) {
+    return hw_intf_->Validate(&disp_layer_stack_.info);
+  }
+
+  ValidateKey key;
+  GetValidateKey(&key);
+  return validate_cache_.Validate(std::move(key), hw_intf_, &disp_layer_stack_.info);
+}
+
 DisplayError DisplayBase::PrePrepare(LayerStack *layer_stack) {
   DTRACE_SCOPED();
   ClientLock lock(disp_mutex_);
@@ -845,6 +904,12 @@ DisplayError DisplayBase::Prepare(LayerStack *layer_stack) {
     return kErrorParameters;
   }
 
+  // Display state changed since the last validation, previously validated configurations may no
+  // longer pass the TEST_ONLY commit.
+  if (!validated_) {
+    validate_cache_.Clear();
+  }
+
   disp_layer_stack_.info.output_buffer = layer_stack->output_buffer;
   disp_layer_stack_.info.hw_cwb_config = layer_stack->cwb_config;
 
@@ -877,7 +942,8 @@ DisplayError DisplayBase::Prepare(LayerStack *layer_stack) {
     }
   }
 
-  if (color_mgr_ && color_mgr_->NeedsPartialUpdateDisable()) {
+  bool pp_update_pending = color_mgr_ && color_mgr_->NeedsPartialUpdateDisable();
+  if (pp_update_pending) {
     DisablePartialUpdateOneFrameInternal();
   }
   // TODO(user): Temporary changes, to be removed when DRM driver supports
@@ -893,6 +959,9 @@ DisplayError DisplayBase::Prepare(LayerStack *layer_stack) {
 
   CheckMMRMState();
 
+  // Pending color feature updates are programmed along with the validate, do not skip it.
+  bool use_validate_cache = !pp_update_pending && CanUseValidateCache();
+
   while (true) {
     error = comp_manager_->Prepare(display_comp_ctx_, &disp_layer_stack_);
     if (error != kErrorNone) {
@@ -901,7 +970,7 @@ DisplayError DisplayBase::Prepare(LayerStack *layer_stack) {
 
     // Trigger validate only if needed.
     if (disp_layer_stack_.info.do_hw_validate) {
-      error = hw_intf_->Validate(&disp_layer_stack_.info);
+      error = ValidateHW(use_validate_cache);
     }
 
     if (error == kErrorNone) {
@@ -1688,21 +1757,46 @@ DisplayError DisplayBase::FlushLocked(LayerStack *layer_stack) {
 }
 
 DisplayError DisplayBase::GetDisplayState(DisplayState *state) {
-  ClientLock lock(disp_mutex_);
   if (!state) {
     return kErrorParameters;
   }
 
+  auto snapshot = GetInfoSnapshot();
+  if (snapshot) {
+    *state = snapshot->state;
+    return kErrorNone;
+  }
+
+  ClientLock lock(disp_mutex_);
   *state = state_;
   return kErrorNone;
 }
 
 DisplayError DisplayBase::GetNumVariableInfoConfigs(uint32_t *count) {
+  auto snapshot = GetInfoSnapshot();
+  if (snapshot) {
+    *count = UINT32(snapshot->configs.size());
+    return kErrorNone;
+  }
+
   ClientLock lock(disp_mutex_);
   return hw_intf_->GetNumDisplayAttributes(count);
 }
 
 DisplayError DisplayBase::GetConfig(uint32_t index, DisplayConfigVariableInfo *variable_info) {
+  auto snapshot = GetInfoSnapshot();
+  if (snapshot) {
+    if (index >= snapshot->configs.size() || !snapshot->config_valid.at(index)) {
+      return kErrorNotSupported;
+    }
+    *variable_info = snapshot->configs.at(index);
+    if (snapshot->custom_mixer_resolution) {
+      variable_info->x_pixels = snapshot->fb_config.x_pixels;
+      variable_info->y_pixels = snapshot->fb_config.y_pixels;
+    }
+    return kErrorNone;
+  }
+
   ClientLock lock(disp_mutex_);
   HWDisplayAttributes attrib;
   if (hw_intf_->GetDisplayAttributes(index, &attrib) == kErrorNone) {
@@ -1718,7 +1812,19 @@ DisplayError DisplayBase::GetConfig(uint32_t index, DisplayConfigVariableInfo *v
 }
 
 DisplayError DisplayBase::GetConfig(DisplayConfigFixedInfo *fixed_info) {
+  auto snapshot = GetInfoSnapshot();
+  if (snapshot) {
+    *fixed_info = snapshot->fixed_info;
+    return kErrorNone;
+  }
+
   ClientLock lock(disp_mutex_);
+  GetFixedConfigLocked(fixed_info);
+
+  return kErrorNone;
+}
+
+void DisplayBase::GetFixedConfigLocked(DisplayConfigFixedInfo *fixed_info) {
   fixed_info->is_cmdmode = (hw_panel_info_.mode == kModeCommand);
 
   HWResourceInfo hw_resource_info = HWResourceInfo();
@@ -1750,11 +1856,53 @@ DisplayError DisplayBase::GetConfig(DisplayConfigFixedInfo *fixed_info) {
   fixed_info->partial_update = hw_panel_info_.partial_update;
   fixed_info->readback_supported = hw_resource_info.has_concurrent_writeback;
   fixed_info->supports_unified_draw = unified_draw_supported_;
+}
 
-  return kErrorNone;
+void DisplayBase::PublishInfoSnapshot() {
+  auto snapshot = std::make_shared<DisplayInfoSnapshot>();
+  uint32_t count = 0;
+
+  // Leave getters on the locked path if the modes can not be queried.
+  if (hw_intf_->GetNumDisplayAttributes(&count) != kErrorNone ||
+      hw_intf_->GetActiveConfig(&snapshot->active_index) != kErrorNone) {
+    std::atomic_store(&info_snapshot_, std::shared_ptr<const DisplayInfoSnapshot>());
+    return;
+  }
+
+  for (uint32_t index = 0; index < count; index++) {
+    HWDisplayAttributes attrib;
+    bool valid = (hw_intf_->GetDisplayAttributes(index, &attrib) == kErrorNone);
+    snapshot->configs.push_back(attrib);
+    snapshot->config_valid.push_back(valid);
+  }
+
+  GetFixedConfigLocked(&snapshot->fixed_info);
+  snapshot->fb_config = fb_config_;
+  snapshot->custom_mixer_resolution = custom_mixer_resolution_;
+  snapshot->state = state_;
+  snapshot->port = hw_panel_info_.port;
+  snapshot->is_primary = hw_panel_info_.is_primary_panel;
+
+  std::atomic_store(&info_snapshot_, std::shared_ptr<const DisplayInfoSnapshot>(snapshot));
+}
+
+void DisplayBase::PublishInfoSnapshot(uint32_t active_index) {
+  auto snapshot = GetInfoSnapshot();
+  if (!snapshot || snapshot->active_index != active_index) {
+    PublishInfoSnapshot();
+  }
 }
 
 DisplayError DisplayBase::GetRealConfig(uint32_t index, DisplayConfigVariableInfo *variable_info) {
+  auto snapshot = GetInfoSnapshot();
+  if (snapshot) {
+    if (index >= snapshot->configs.size() || !snapshot->config_valid.at(index)) {
+      return kErrorNotSupported;
+    }
+    *variable_info = snapshot->configs.at(index);
+    return kErrorNone;
+  }
+
   ClientLock lock(disp_mutex_);
   HWDisplayAttributes attrib;
   if (hw_intf_->GetDisplayAttributes(index, &attrib) == kErrorNone) {
@@ -1766,6 +1914,12 @@ DisplayError DisplayBase::GetRealConfig(uint32_t index, DisplayConfigVariableInf
 }
 
 DisplayError DisplayBase::GetActiveConfig(uint32_t *index) {
+  auto snapshot = GetInfoSnapshot();
+  if (snapshot) {
+    *index = snapshot->active_index;
+    return kErrorNone;
+  }
+
   ClientLock lock(disp_mutex_);
   return hw_intf_->GetActiveConfig(index);
 }
@@ -1949,6 +2103,7 @@ DisplayError DisplayBase::SetDisplayState(DisplayState state, bool teardown,
       }
     }
     comp_manager_->SetDisplayState(display_comp_ctx_, state, sync_points);
+    PublishInfoSnapshot();
   }
   DLOGI("active %d-%d state %d-%d pending_power_state_ %d", active, active_, state, state_,
         pending_power_state_);
@@ -2081,6 +2236,12 @@ std::string DisplayBase::Dump() {
   os << " clk: " << display_attributes_.clock_khz;
   os << " Topology: " << display_attributes_.topology;
   os << std::noboolalpha;
+  os << "\nValidate cache: hits " << validate_cache_.GetHits() << " misses "
+     << validate_cache_.GetMisses() << " cached " << validate_cache_.Size() << "/"
+     << ValidateCache::kMaxValidatedConfigs;
+  uint64_t memo_hits = 0, memo_misses = 0;
+  comp_manager_->GetStrategyMemoStats(display_comp_ctx_, &memo_hits, &memo_misses);
+  os << "\nStrategy memo: hits " << memo_hits << " misses " << memo_misses;
 
   os << "\nCurrent Color Mode: " << current_color_mode_.c_str();
   os << "\nAvailable Color Modes:\n";
@@ -2792,6 +2953,7 @@ DisplayError DisplayBase::ReconfigureDisplay() {
   bool mixer_unchanged = (mixer_attributes == mixer_attributes_);
   bool panel_unchanged = (hw_panel_info == hw_panel_info_);
   if (display_unchanged && mixer_unchanged && panel_unchanged) {
+    PublishInfoSnapshot(active_index);
     return kErrorNone;
   }
 
@@ -2820,6 +2982,8 @@ DisplayError DisplayBase::ReconfigureDisplay() {
     pu_pending_ = true;
   }
 
+  PublishInfoSnapshot();
+
   return kErrorNone;
 }
 
@@ -3052,17 +3216,24 @@ DisplayError DisplayBase::SetFrameBufferConfig(const DisplayConfigVariableInfo &
   fb_config_.y_pixels = height;
 
   DLOGI("New framebuffer resolution (%dx%d)", fb_config_.x_pixels, fb_config_.y_pixels);
+  PublishInfoSnapshot();
 
   return kErrorNone;
 }
 
 DisplayError DisplayBase::GetFrameBufferConfig(DisplayConfigVariableInfo *variable_info) {
   DTRACE_SCOPED();
-  ClientLock lock(disp_mutex_);
   if (!variable_info) {
     return kErrorParameters;
   }
 
+  auto snapshot = GetInfoSnapshot();
+  if (snapshot) {
+    *variable_info = snapshot->fb_config;
+    return kErrorNone;
+  }
+
+  ClientLock lock(disp_mutex_);
   *variable_info = fb_config_;
 
   return kErrorNone;
@@ -3088,12 +3259,17 @@ DisplayError DisplayBase::SetDetailEnhancerData(const DisplayDetailEnhancerData
 }
 
 DisplayError DisplayBase::GetDisplayPort(DisplayPort *port) {
-  ClientLock lock(disp_mutex_);
-
   if (!port) {
     return kErrorParameters;
   }
 
+  auto snapshot = GetInfoSnapshot();
+  if (snapshot) {
+    *port = snapshot->port;
+    return kErrorNone;
+  }
+
+  ClientLock lock(disp_mutex_);
   *port = hw_panel_info_.port;
 
   return kErrorNone;
@@ -3124,6 +3300,11 @@ DisplayError DisplayBase::GetDisplayType(DisplayType *display_type) {
 }
 
 bool DisplayBase::IsPrimaryDisplay() {
+  auto snapshot = GetInfoSnapshot();
+  if (snapshot) {
+    return snapshot->is_primary;
+  }
+
   ClientLock lock(disp_mutex_);
 
   return IsPrimaryDisplayLocked();
@@ -3662,6 +3843,7 @@ DisplayError DisplayBase::ResetPendingPowerState(const shared_ptr<Fence> &retire
     active_ = true;
 
     pending_power_state_ = kPowerStateNone;
+    PublishInfoSnapshot();
   }
   return kErrorNone;
 }
@@ -47,6 +47,7 @@
 
 #include <limits.h>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <condition_variable>  // NOLINT
@@ -55,6 +56,7 @@
 
 #include "comp_manager.h"
 #include "color_manager.h"
+#include "validate_cache.h"
 
 #define GET_PANEL_FEATURE_FACTORY "GetPanelFeatureFactoryIntf"
 #define GET_DEMURATN_FACTORY "GetDemuraTnCoreUvmFactoryIntf"
@@ -334,6 +336,9 @@ class DisplayBase : public DisplayInterface, public CompManagerEventHandler {
   DisplayError PerformCommit(HWLayersInfo *hw_layers_info);
   virtual DisplayError PostCommit(HWLayersInfo *hw_layers_info);
   bool IsPrimaryDisplayLocked();
+  virtual void GetFixedConfigLocked(DisplayConfigFixedInfo *fixed_info);
+  void PublishInfoSnapshot();
+  void PublishInfoSnapshot(uint32_t active_index);
   virtual DisplayError CommitLocked(LayerStack *layer_stack);
   void ConfigureCwbParams(LayerStack *layer_stack);
   void ProcessPowerEvent();
@@ -441,6 +446,25 @@ class DisplayBase : public DisplayInterface, public CompManagerEventHandler {
   // Max tolerable power-state-change wait-times in milliseconds.
   static const int kPowerStateTimeout = 5000;
 
+  // Display info served to clients. Rebuilt under disp_mutex_ whenever mode, power state or
+  // framebuffer config change and swapped in atomically, so getters need not wait for a Prepare
+  // or Commit in progress.
+  struct DisplayInfoSnapshot {
+    DisplayConfigFixedInfo fixed_info = {};
+    std::vector<DisplayConfigVariableInfo> configs = {};  // Real attributes of each mode
+    std::vector<bool> config_valid = {};
+    uint32_t active_index = 0;
+    DisplayConfigVariableInfo fb_config = {};
+    bool custom_mixer_resolution = false;
+    DisplayState state = kStateOff;
+    DisplayPort port = kPortDefault;
+    bool is_primary = false;
+  };
+
+  std::shared_ptr<const DisplayInfoSnapshot> GetInfoSnapshot() const {
+    return std::atomic_load(&info_snapshot_);
+  }
+
   bool StartDisplayPowerReset();
   void EndDisplayPowerReset();
   DisplayError PrepareRC(LayerStack *layer_stack);
@@ -456,6 +480,9 @@ class DisplayBase : public DisplayInterface, public CompManagerEventHandler {
   void UpdateFrameBuffer();
   void CleanupOnError();
   bool IsValidateNeeded();
+  bool CanUseValidateCache();
+  void GetValidateKey(ValidateKey *key);
+  DisplayError ValidateHW(bool use_validate_cache);
   DisplayError InitBorderLayers();
   std::vector<LayerRect> GetBorderRects();
   void GenerateBorderLayers(const std::vector<LayerRect> &border_rects);
@@ -467,6 +494,11 @@ class DisplayBase : public DisplayInterface, public CompManagerEventHandler {
   unsigned int rc_cached_fb_height_ = 0;
   std::unique_ptr<RCIntf> rc_core_ = nullptr;
   bool rc_prepared_ = false;  // Used to avoid calling into RC core b/w Prepare and PrePrepare
+  // Configurations which passed the TEST_ONLY commit. Cleared whenever the display validation
+  // state gets reset.
+  ValidateCache validate_cache_;
+  bool disable_validate_cache_ = false;
+  std::shared_ptr<const DisplayInfoSnapshot> info_snapshot_ = nullptr;
   bool mmrm_updated_ = false;
   uint32_t mmrm_requested_clk_ = 0;
   static bool primary_active_;
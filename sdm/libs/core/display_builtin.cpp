@@ -2421,6 +2421,7 @@ DisplayError DisplayBuiltIn::ReconfigureDisplay() {
   const bool mixer_unchanged = (mixer_attributes == mixer_attributes_);
   const bool panel_unchanged = (hw_panel_info == hw_panel_info_);
   if (!dirty && display_unchanged && mixer_unchanged && panel_unchanged) {
+    PublishInfoSnapshot(active_index);
     return kErrorNone;
   }
 
@@ -2467,6 +2468,8 @@ DisplayError DisplayBuiltIn::ReconfigureDisplay() {
     dpps_info_.DppsNotifyOps(kDppsUpdateFpsEvent, &dpps_payload, sizeof(dpps_payload));
   }
 
+  PublishInfoSnapshot();
+
   return kErrorNone;
 }
 
@@ -2515,8 +2518,7 @@ PrimariesTransfer DisplayBuiltIn::GetBlendSpaceFromStcColorMode(
   return blend_space;
 }
 
-DisplayError DisplayBuiltIn::GetConfig(DisplayConfigFixedInfo *fixed_info) {
-  ClientLock lock(disp_mutex_);
+void DisplayBuiltIn::GetFixedConfigLocked(DisplayConfigFixedInfo *fixed_info) {
   fixed_info->is_cmdmode = (hw_panel_info_.mode == kModeCommand);
 
   HWResourceInfo hw_resource_info = HWResourceInfo();
@@ -2540,8 +2542,6 @@ DisplayError DisplayBuiltIn::GetConfig(DisplayConfigFixedInfo *fixed_info) {
   fixed_info->partial_update = hw_panel_info_.partial_update;
   fixed_info->readback_supported = hw_resource_info.has_concurrent_writeback;
   fixed_info->supports_unified_draw = unified_draw_supported_;
-
-  return kErrorNone;
 }
 
 void DisplayBuiltIn::SendBacklight() {
@@ -3036,9 +3036,50 @@ uint32_t DisplayBuiltIn::GetOptimalRefreshRate(bool one_updating_layer) {
     return metadata_refresh_rate;
   }
 
+  uint32_t content_refresh_rate = CalculateContentRefreshRate();
+  if (content_refresh_rate && content_refresh_rate < active_refresh_rate_) {
+    return content_refresh_rate;
+  }
+
   return active_refresh_rate_;
 }
 
+uint32_t DisplayBuiltIn::CalculateContentRefreshRate() {
+  LayerStack *layer_stack = disp_layer_stack_.stack;
+  if (!layer_stack->flags.use_metadata_refresh_rate) {
+    return 0;
+  }
+
+  // Every updating layer votes with its metadata or measured rate, the highest vote wins. A layer
+  // updating at an unknown rate keeps the active refresh rate.
+  uint32_t content_refresh_rate = 0;
+  for (auto layer : layer_stack->layers) {
+    if (layer->composition == kCompositionGPUTarget) {
+      break;
+    }
+    if (!layer->flags.updating) {
+      continue;
+    }
+
+    uint32_t vote = layer->flags.has_metadata_refresh_rate ? layer->frame_rate :
+                    layer->content_frame_rate;
+    if (!vote) {
+      return 0;
+    }
+    content_refresh_rate = std::max(content_refresh_rate, vote);
+  }
+
+  if (!content_refresh_rate) {
+    return 0;
+  }
+
+  uint32_t max_refresh_rate = 0;
+  uint32_t min_refresh_rate = 0;
+  GetRefreshRateRange(&min_refresh_rate, &max_refresh_rate);
+
+  return SanitizeRefreshRate(content_refresh_rate, max_refresh_rate, min_refresh_rate);
+}
+
 uint32_t DisplayBuiltIn::CalculateMetaDataRefreshRate() {
   LayerStack *layer_stack = disp_layer_stack_.stack;
   uint32_t metadata_refresh_rate = 0;
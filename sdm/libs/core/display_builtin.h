@@ -178,7 +178,6 @@ class DisplayBuiltIn : public DisplayBase, HWEventHandler, DppsPropIntf {
   DisplayError NotifyDisplayCalibrationMode(bool in_calibration) override;
   bool HasDemura() override { return demura_intended_; }
   std::string Dump() override;
-  DisplayError GetConfig(DisplayConfigFixedInfo *fixed_info) override;
   DisplayError PrePrepare(LayerStack *layer_stack) override;
   DisplayError SetAlternateDisplayConfig(uint32_t *alt_config) override;
   DisplayError HandleSecureEvent(SecureEvent secure_event, bool *needs_refresh) override;
@@ -191,6 +190,7 @@ class DisplayBuiltIn : public DisplayBase, HWEventHandler, DppsPropIntf {
   uint32_t GetUpdatingLayersCount();
   uint32_t GetOptimalRefreshRate(bool one_updating_layer);
   uint32_t CalculateMetaDataRefreshRate();
+  uint32_t CalculateContentRefreshRate();
   uint32_t SanitizeRefreshRate(uint32_t req_refresh_rate, uint32_t max_refresh_rate,
                                uint32_t min_refresh_rate);
   DisplayError UpdateTransferTime(uint32_t transfer_time) override;
@@ -222,6 +222,7 @@ class DisplayBuiltIn : public DisplayBase, HWEventHandler, DppsPropIntf {
   DisplayError SetUpCommit(LayerStack *layer_stack) override;
   DisplayError PostCommit(HWLayersInfo *hw_layers_info) override;
   DisplayError GetQsyncFps(uint32_t *qsync_fps) override;
+  void GetFixedConfigLocked(DisplayConfigFixedInfo *fixed_info) override;
 
  private:
   bool CanCompareFrameROI(LayerStack *layer_stack);
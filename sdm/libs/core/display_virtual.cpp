@@ -164,6 +164,7 @@ DisplayError DisplayVirtual::SetActiveConfig(DisplayConfigVariableInfo *variable
 
   DLOGI("Virtual display %d-%d resolution changed to [%dx%d]", display_id_,
         display_type_, display_attributes_.x_pixels, display_attributes_.y_pixels);
+  PublishInfoSnapshot();
 
   return kErrorNone;
 }
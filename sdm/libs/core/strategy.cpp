@@ -28,6 +28,9 @@
 
 #include <utils/constants.h>
 #include <utils/debug.h>
+#include <utils/utils.h>
+#include <algorithm>
+#include <utility>
 #include <vector>
 
 #include "strategy.h"
@@ -71,6 +74,11 @@ DisplayError Strategy::Init() {
         display_attributes_, fb_config_, &partial_update_intf_);
   }
 
+  int value = 0;
+  if (Debug::Get()->GetProperty(ENABLE_STRATEGY_MEMO_PROP, &value) == kErrorNone) {
+    enable_strategy_memo_ = (value == 1);
+  }
+
   return kErrorNone;
 }
 
@@ -112,6 +120,32 @@ DisplayError Strategy::Start(DispLayerStack *disp_layer_stack, uint32_t *max_att
     }
   }
 
+  memo_pending_ = false;
+  memo_replayed_ = false;
+  if (enable_strategy_memo_ && extn_start_success_) {
+    signature_ = {};
+    GetLayerStackSignature(*constraints, &signature_);
+    bool skip_validate = (error == kErrorNone || error == kErrorNeedsLutRegen);
+
+    // Extension decides on skipping validate against the strategy it computed last, which is not
+    // the one programmed if that frame was replayed from the memo.
+    if (skip_validate && signature_ != committed_signature_) {
+      error = kErrorNeedsValidate;
+      skip_validate = false;
+    }
+
+    if (!skip_validate) {
+      memo_pending_ = (FindStrategyMemo(signature_) != strategy_memos_.end());
+      if (memo_pending_) {
+        memo_hits_++;
+        // Memo candidate is tried ahead of the strategies of the extension.
+        (*max_attempts)++;
+      } else {
+        memo_misses_++;
+      }
+    }
+  }
+
   disp_layer_stack_->stack->flags.default_strategy = !extn_start_success_;
   return error;
 }
@@ -132,6 +166,28 @@ DisplayError Strategy::GetNextStrategy() {
   }
 
   if (extn_start_success_) {
+    if (enable_strategy_memo_) {
+      prepared_ = true;
+      prepared_signature_ = signature_;
+
+      if (memo_pending_) {
+        memo_pending_ = false;
+        memo_replayed_ = ReplayStrategyMemo();
+        if (memo_replayed_) {
+          return kErrorNone;
+        }
+      } else if (memo_replayed_) {
+        // Replayed strategy did not fit the current resources, drop it.
+        DLOGI_IF(kTagStrategy, "Memoized strategy rejected for display %d-%d", display_id_,
+                 display_type_);
+        memo_replayed_ = false;
+        auto it = FindStrategyMemo(signature_);
+        if (it != strategy_memos_.end()) {
+          strategy_memos_.erase(it);
+        }
+      }
+    }
+
     return strategy_intf_->GetNextStrategy();
   }
 
@@ -173,6 +229,162 @@ DisplayError Strategy::GetNextStrategy() {
   return kErrorNone;
 }
 
+void Strategy::CacheStrategy() {
+  if (!enable_strategy_memo_ || !prepared_) {
+    return;
+  }
+
+  prepared_ = false;
+  committed_signature_ = prepared_signature_;
+
+  HWLayersInfo &info = disp_layer_stack_->info;
+  if (info.pvt_data) {
+    // Strategies carrying private data of the extension can not be replayed.
+    return;
+  }
+
+  auto it = FindStrategyMemo(committed_signature_);
+  if (it != strategy_memos_.end()) {
+    // A committed stack with a known signature was either replayed from this memo or skipped
+    // validation against it, so the recorded strategy is current; only refresh its recency.
+    if (it != strategy_memos_.begin()) {
+      StrategyMemo memo = std::move(*it);
+      strategy_memos_.erase(it);
+      strategy_memos_.push_front(std::move(memo));
+    }
+    return;
+  }
+
+  if (strategy_memos_.size() >= kMaxStrategyMemos) {
+    strategy_memos_.pop_back();
+  }
+
+  StrategyMemo memo;
+  memo.signature = committed_signature_;
+  for (auto &layer : disp_layer_stack_->stack->layers) {
+    memo.compositions.push_back(layer->composition);
+    memo.requests.push_back(layer->request);
+  }
+  memo.index = info.index;
+  memo.roi_index = info.roi_index;
+  for (auto &hw_layer : info.hw_layers) {
+    memo.hw_layers.push_back({hw_layer.composition, hw_layer.request, hw_layer.src_rect,
+                              hw_layer.dst_rect});
+  }
+
+  strategy_memos_.push_front(std::move(memo));
+}
+
+void Strategy::GetMemoStats(uint64_t *hits, uint64_t *misses) {
+  *hits = memo_hits_;
+  *misses = memo_misses_;
+}
+
+void Strategy::GetLayerStackSignature(const StrategyConstraints &constraints,
+                                      HashedKey *signature) {
+  LayerStack *layer_stack = disp_layer_stack_->stack;
+  HWLayersInfo &info = disp_layer_stack_->info;
+
+  signature->Add((UINT64(layer_stack->layers.size()) << 32) | layer_stack->flags.flags);
+  signature->Add((UINT64(constraints.safe_mode) << 35) | (UINT64(constraints.idle_timeout) << 34) |
+                 (UINT64(constraints.gpu_fallback_mode) << 33) |
+                 (UINT64(constraints.tonemapping_query_mandatory) << 32) |
+                 constraints.max_layers);
+  signature->Add((UINT64(info.app_layer_count) << 32) | UINT32(info.gpu_target_index));
+
+  for (auto &layer : layer_stack->layers) {
+    const LayerBuffer &input_buffer = layer->input_buffer;
+    signature->Add((UINT64(input_buffer.format) << 32) | input_buffer.flags.flags);
+    signature->Add((UINT64(input_buffer.width) << 32) | input_buffer.height);
+    signature->Add((UINT64(input_buffer.color_metadata.colorPrimaries) << 32) |
+                   input_buffer.color_metadata.transfer);
+    // Geometry clean frames reuse the memo while a layer animates, a new buffer alone does not
+    // change the strategy.
+    LayerFlags flags = layer->flags;
+    flags.buffer_updated = 0;
+    signature->Add((UINT64(flags.flags) << 32) | (UINT64(layer->composition) << 16) |
+                   (UINT64(layer->blending) << 8) | layer->plane_alpha);
+    signature->Add((UINT64(layer->transform.flip_horizontal) << 33) |
+                   (UINT64(layer->transform.flip_vertical) << 32) |
+                   UINT32(layer->transform.rotation));
+    signature->AddRect(layer->src_rect);
+    signature->AddRect(layer->dst_rect);
+    if (layer_stack->flags.layer_id_support) {
+      signature->Add(layer->layer_id);
+    }
+  }
+
+  for (auto &roi : info.left_frame_roi) {
+    signature->AddRect(roi);
+  }
+  for (auto &roi : info.right_frame_roi) {
+    signature->AddRect(roi);
+  }
+}
+
+std::deque<Strategy::StrategyMemo>::iterator Strategy::FindStrategyMemo(
+    const HashedKey &signature) {
+  // Memos are matched on the full signature, layer stacks colliding on the hash are told apart.
+  return std::find_if(strategy_memos_.begin(), strategy_memos_.end(),
+                      [&signature](const StrategyMemo &memo) {
+                        return memo.signature == signature;
+                      });
+}
+
+bool Strategy::ReplayStrategyMemo() {
+  auto it = FindStrategyMemo(signature_);
+  if (it == strategy_memos_.end()) {
+    return false;
+  }
+
+  LayerStack *layer_stack = disp_layer_stack_->stack;
+  HWLayersInfo &info = disp_layer_stack_->info;
+  const StrategyMemo &memo = *it;
+  if (memo.compositions.size() != layer_stack->layers.size() ||
+      memo.index.size() != memo.hw_layers.size()) {
+    return false;
+  }
+
+  for (auto layer_index : memo.index) {
+    if (layer_index >= layer_stack->layers.size()) {
+      return false;
+    }
+  }
+
+  for (uint32_t i = 0; i < layer_stack->layers.size(); i++) {
+    layer_stack->layers.at(i)->composition = memo.compositions.at(i);
+    layer_stack->layers.at(i)->request = memo.requests.at(i);
+  }
+
+  info.index = memo.index;
+  info.roi_index = memo.roi_index;
+  // Start from the layers of this frame so buffers, fences, buffer maps and per frame metadata are
+  // current, then apply what the strategy decided for them.
+  info.hw_layers.clear();
+  for (uint32_t i = 0; i < memo.hw_layers.size(); i++) {
+    const HWLayerMemo &hw_layer_memo = memo.hw_layers.at(i);
+    Layer hw_layer = *layer_stack->layers.at(info.index.at(i));
+    hw_layer.composition = hw_layer_memo.composition;
+    hw_layer.request = hw_layer_memo.request;
+    hw_layer.src_rect = hw_layer_memo.src_rect;
+    hw_layer.dst_rect = hw_layer_memo.dst_rect;
+    info.hw_layers.push_back(hw_layer);
+  }
+
+  DLOGI_IF(kTagStrategy, "Replaying memoized strategy for display %d-%d", display_id_,
+           display_type_);
+
+  return true;
+}
+
+void Strategy::ClearStrategyMemo() {
+  strategy_memos_.clear();
+  committed_signature_ = {};
+  prepared_signature_ = {};
+  memo_pending_ = false;
+  memo_replayed_ = false;
+}
+
 void Strategy::GenerateROI() {
   bool split_display = false;
 
@@ -230,6 +442,7 @@ DisplayError Strategy::Reconfigure(const HWPanelInfo &hw_panel_info,
     return error;
   }
 
+  ClearStrategyMemo();
   hw_panel_info_ = hw_panel_info;
   display_attributes_ = display_attributes;
   mixer_attributes_ = mixer_attributes;
@@ -246,6 +459,8 @@ DisplayError Strategy::SetCompositionState(LayerComposition composition_type, bo
     disable_gpu_comp_ = !enable;
   }
 
+  ClearStrategyMemo();
+
   if (strategy_intf_) {
     return strategy_intf_->SetCompositionState(composition_type, enable);
   }
@@ -254,6 +469,8 @@ DisplayError Strategy::SetCompositionState(LayerComposition composition_type, bo
 }
 
 DisplayError Strategy::Purge() {
+  ClearStrategyMemo();
+
   if (strategy_intf_) {
     return strategy_intf_->Purge();
   }
@@ -262,6 +479,8 @@ DisplayError Strategy::Purge() {
 }
 
 DisplayError Strategy::SetDrawMethod(const DisplayDrawMethod &draw_method) {
+  ClearStrategyMemo();
+
   if (strategy_intf_) {
     return strategy_intf_->SetDrawMethod(draw_method);
   }
@@ -270,6 +489,8 @@ DisplayError Strategy::SetDrawMethod(const DisplayDrawMethod &draw_method) {
 }
 
 DisplayError Strategy::SetIdleTimeoutMs(uint32_t active_ms, uint32_t inactive_ms) {
+  ClearStrategyMemo();
+
   if (strategy_intf_) {
     return strategy_intf_->SetIdleTimeoutMs(active_ms, inactive_ms);
   }
@@ -278,6 +499,8 @@ DisplayError Strategy::SetIdleTimeoutMs(uint32_t active_ms, uint32_t inactive_ms
 }
 
 DisplayError Strategy::SetColorModesInfo(const std::vector<PrimariesTransfer> &colormodes_cs) {
+  ClearStrategyMemo();
+
   if (strategy_intf_) {
     return strategy_intf_->SetColorModesInfo(colormodes_cs);
   }
@@ -285,6 +508,8 @@ DisplayError Strategy::SetColorModesInfo(const std::vector<PrimariesTransfer> &c
 }
 
 DisplayError Strategy::SetBlendSpace(const PrimariesTransfer &blend_space) {
+  ClearStrategyMemo();
+
   if (strategy_intf_) {
     return strategy_intf_->SetBlendSpace(blend_space);
   }
@@ -28,6 +28,8 @@
 #include <core/display_interface.h>
 #include <private/extension_interface.h>
 #include <core/buffer_allocator.h>
+#include <utils/utils.h>
+#include <deque>
 #include <vector>
 
 namespace sdm {
@@ -58,9 +60,37 @@ class Strategy {
   DisplayError SetColorModesInfo(const std::vector<PrimariesTransfer> &colormodes_cs);
   DisplayError SetBlendSpace(const PrimariesTransfer &blend_space);
   void GenerateROI(DispLayerStack *disp_layer_stack, const PUConstraints &pu_constraints);
+  void CacheStrategy();
+  void GetMemoStats(uint64_t *hits, uint64_t *misses);
 
  private:
+  // Composition chosen for a previously committed layer stack. Replayed as the first strategy for a
+  // layer stack with the same signature instead of querying the strategy extension.
+  // Only the fields of a hw layer the strategy decides on. The rest is taken from the layer stack
+  // of the frame being replayed, so no buffers or buffer maps of the recorded frame are retained.
+  struct HWLayerMemo {
+    LayerComposition composition = kCompositionGPU;
+    LayerRequest request = {};
+    LayerRect src_rect = {};
+    LayerRect dst_rect = {};
+  };
+
+  struct StrategyMemo {
+    HashedKey signature = {};
+    std::vector<LayerComposition> compositions = {};
+    std::vector<LayerRequest> requests = {};
+    std::vector<uint32_t> index = {};
+    std::vector<uint32_t> roi_index = {};
+    std::vector<HWLayerMemo> hw_layers = {};
+  };
+
   void GenerateROI();
+  void GetLayerStackSignature(const StrategyConstraints &constraints, HashedKey *signature);
+  std::deque<StrategyMemo>::iterator FindStrategyMemo(const HashedKey &signature);
+  bool ReplayStrategyMemo();
+  void ClearStrategyMemo();
+
+  static const uint32_t kMaxStrategyMemos = 8;
 
   ExtensionInterface *extension_intf_ = NULL;
   StrategyInterface *strategy_intf_ = NULL;
@@ -76,6 +106,16 @@ class Strategy {
   bool extn_start_success_ = false;
   bool disable_gpu_comp_ = false;
   BufferAllocator *buffer_allocator_ = NULL;
+  bool enable_strategy_memo_ = false;
+  std::deque<StrategyMemo> strategy_memos_ = {};  // Most recently used first
+  HashedKey signature_ = {};            // Signature of the layer stack passed to Start()
+  HashedKey prepared_signature_ = {};   // Signature of the layer stack last prepared
+  HashedKey committed_signature_ = {};  // Signature of the layer stack last committed
+  bool memo_pending_ = false;
+  bool memo_replayed_ = false;
+  bool prepared_ = false;
+  uint64_t memo_hits_ = 0;
+  uint64_t memo_misses_ = 0;
 };
 
 }  // namespace sdm
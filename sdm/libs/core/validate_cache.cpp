@@ -0,0 +1,197 @@
+/*
+* Copyright (c) 2024 The Linux Foundation. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of The Linux Foundation nor the names of its
+*       contributors may be used to endorse or promote products derived
+*       from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+* OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+* IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <utils/debug.h>
+#include <utils/utils.h>
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "validate_cache.h"
+
+#define __CLASS__ "ValidateCache"
+
+namespace sdm {
+
+static void AddCsc(const HWCsc &csc, ValidateKey *key) {
+  for (auto coeff : csc.ctm_coeff) {
+    key->Add(UINT64(coeff));
+  }
+  for (uint32_t i = 0; i < MAX_CSC_BIAS_SIZE; i++) {
+    key->Add((UINT64(csc.pre_bias[i]) << 32) | csc.post_bias[i]);
+  }
+  for (uint32_t i = 0; i < MAX_CSC_CLAMP_SIZE; i++) {
+    key->Add((UINT64(csc.pre_clamp[i]) << 32) | csc.post_clamp[i]);
+  }
+}
+
+static void AddPipeInfo(const HWPipeInfo &pipe, ValidateKey *key) {
+  if (!pipe.valid) {
+    key->Add(0);
+    return;
+  }
+
+  key->Add((UINT64(pipe.pipe_id) << 32) | (UINT64(pipe.rect) << 24) | pipe.z_order);
+  key->Add((UINT64(pipe.flags) << 32) | UINT32(pipe.format));
+  key->Add((UINT64(pipe.sub_block_type) << 32) | (UINT64(pipe.tonemap) << 24) |
+           (UINT64(pipe.horizontal_decimation) << 16) | (UINT64(pipe.vertical_decimation) << 8) |
+           (UINT64(pipe.is_solid_fill) << 1) | pipe.is_virtual);
+  key->Add((UINT64(pipe.lut_info.size()) << 32) | (UINT64(pipe.transform.flip_horizontal) << 17) |
+           (UINT64(pipe.transform.flip_vertical) << 16) | UINT32(pipe.transform.rotation));
+  key->AddRect(pipe.src_roi);
+  key->AddRect(pipe.dst_roi);
+  key->AddRect(pipe.excl_rect);
+
+  // Tone map programming of the pipe. LUT payloads are opaque, so pipes writing a LUT make the
+  // frame uncacheable in CanUseValidateCache(); the CSC and PMA state is covered here.
+  key->Add((UINT64(pipe.inverse_pma_info.op) << 32) | pipe.inverse_pma_info.inverse_pma);
+  key->Add((UINT64(pipe.dgm_csc_info.op) << 32) | pipe.dgm_csc_info.dgm_csc_config);
+  if (pipe.dgm_csc_info.op != kNoOp) {
+    AddCsc(pipe.dgm_csc_info.csc, key);
+  }
+  for (auto &lut_info : pipe.lut_info) {
+    key->Add((UINT64(lut_info.op) << 32) | UINT32(lut_info.type));
+  }
+
+  const HWScaleData &scale_data = pipe.scale_data;
+  key->Add((UINT64(scale_data.enable.scale) << 24) |
+           (UINT64(scale_data.enable.direction_detection) << 16) |
+           (UINT64(scale_data.enable.detail_enhance) << 8) | scale_data.enable.dyn_exp_disable);
+  key->Add((UINT64(scale_data.dst_width) << 32) | scale_data.dst_height);
+  for (uint32_t i = 0; i < MAX_PLANES; i++) {
+    const HWPlane &plane = scale_data.plane[i];
+    key->Add((UINT64(plane.src_width) << 32) | plane.src_height);
+    key->Add((UINT64(UINT32(plane.phase_step_x)) << 32) | UINT32(plane.phase_step_y));
+  }
+}
+
+void ValidateKey::AddLayers(const HWLayersInfo &hw_layers_info) {
+  uint32_t hw_layer_count = UINT32(hw_layers_info.hw_layers.size());
+  Add(hw_layer_count);
+
+  for (uint32_t i = 0; i < hw_layer_count && i < kMaxSDELayers; i++) {
+    const Layer &layer = hw_layers_info.hw_layers.at(i);
+    const LayerBuffer &input_buffer = layer.input_buffer;
+    Add((UINT64(input_buffer.format) << 32) | input_buffer.flags.flags);
+    Add((UINT64(input_buffer.width) << 32) | input_buffer.height);
+    // A new buffer alone leaves the validated configuration as it is.
+    LayerFlags flags = layer.flags;
+    flags.buffer_updated = 0;
+    Add((UINT64(flags.flags) << 32) | (UINT64(layer.blending) << 8) | layer.plane_alpha);
+    AddRect(layer.src_rect);
+    AddRect(layer.dst_rect);
+
+    const HWLayerConfig &layer_config = hw_layers_info.config[i];
+    AddPipeInfo(layer_config.left_pipe, this);
+    AddPipeInfo(layer_config.right_pipe, this);
+    Add((UINT64(layer_config.use_inline_rot) << 2) |
+             (UINT64(layer_config.use_solidfill_stage) << 1) |
+             layer_config.hw_noise_layer_cfg.enable);
+    if (layer_config.use_solidfill_stage) {
+      const HWSolidfillStage &solidfill_stage = layer_config.hw_solidfill_stage;
+      Add((UINT64(solidfill_stage.z_order) << 1) | solidfill_stage.is_exclusion_rect);
+      AddRect(solidfill_stage.roi);
+    }
+  }
+
+  for (auto &roi : hw_layers_info.left_frame_roi) {
+    AddRect(roi);
+  }
+  for (auto &roi : hw_layers_info.right_frame_roi) {
+    AddRect(roi);
+  }
+  AddRect(hw_layers_info.partial_fb_roi);
+
+  for (auto &dest_scale_info : hw_layers_info.dest_scale_info_map) {
+    const HWDestScaleInfo *info = dest_scale_info.second;
+    Add(dest_scale_info.first);
+    if (info) {
+      Add((UINT64(info->mixer_width) << 32) | info->mixer_height);
+      Add((UINT64(info->scale_update) << 1) | info->scale_data.enable.scale);
+      AddRect(info->panel_roi);
+    }
+  }
+
+  const HWQosData &qos_data = hw_layers_info.qos_data;
+  Add((UINT64(qos_data.clock_hz) << 32) | qos_data.rot_clock_hz);
+  Add(qos_data.core_ab_bps);
+  Add(qos_data.core_ib_bps);
+  Add(qos_data.llcc_ab_bps);
+  Add(qos_data.llcc_ib_bps);
+  Add(qos_data.dram_ab_bps);
+  Add(qos_data.dram_ib_bps);
+  Add(qos_data.rot_prefill_bw_bps);
+
+  uint32_t output_compression = 0;
+  std::memcpy(&output_compression, &hw_layers_info.output_compression, sizeof(uint32_t));
+  Add((UINT64(output_compression) << 32) | (UINT64(hw_layers_info.roi_split) << 5) |
+           (UINT64(hw_layers_info.spr_enable) << 4) | (UINT64(hw_layers_info.rc_config) << 3) |
+           (UINT64(hw_layers_info.noise_layer_info.enable) << 2) |
+           (UINT64(hw_layers_info.iwe_enabled) << 1) | hw_layers_info.demura_present);
+  Add((UINT64(hw_layers_info.blend_cs.primaries) << 32) | hw_layers_info.blend_cs.transfer);
+}
+
+DisplayError ValidateCache::Validate(ValidateKey key, HWInterface *hw_intf,
+                                     HWLayersInfo *hw_layers_info) {
+  // Idle power collapse, self refresh and VM ownership requests are programmed by hw_intf itself.
+  uint64_t hw_state = 0;
+  if (hw_intf->GetValidateState(&hw_state) != kErrorNone) {
+    return hw_intf->Validate(hw_layers_info);
+  }
+  key.Add(hw_state);
+
+  // Configurations are matched on their full key, the hash only speeds up the comparison.
+  auto it = std::find(validated_configs_.begin(), validated_configs_.end(), key);
+  if (it != validated_configs_.end()) {
+    // Identical configuration passed the TEST_ONLY commit already, skip the round trip.
+    hits_++;
+    DLOGV_IF(kTagDisplay, "Validate skipped for key 0x%" PRIx64, key.hash);
+    if (it != validated_configs_.begin()) {
+      validated_configs_.erase(it);
+      validated_configs_.push_front(std::move(key));
+    }
+    return kErrorNone;
+  }
+
+  misses_++;
+  DisplayError error = hw_intf->Validate(hw_layers_info);
+  if (error != kErrorNone) {
+    validated_configs_.clear();
+    return error;
+  }
+
+  validated_configs_.push_front(std::move(key));
+  if (validated_configs_.size() > kMaxValidatedConfigs) {
+    validated_configs_.pop_back();
+  }
+
+  return kErrorNone;
+}
+
+}  // namespace sdm
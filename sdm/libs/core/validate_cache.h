@@ -0,0 +1,68 @@
+/*
+* Copyright (c) 2024 The Linux Foundation. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of The Linux Foundation nor the names of its
+*       contributors may be used to endorse or promote products derived
+*       from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+* OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+* IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef __VALIDATE_CACHE_H__
+#define __VALIDATE_CACHE_H__
+
+#include <private/hw_interface.h>
+#include <private/hw_info_types.h>
+#include <utils/utils.h>
+#include <deque>
+
+namespace sdm {
+
+// State of a HW layer configuration which decides the outcome of the TEST_ONLY commit.
+struct ValidateKey : public HashedKey {
+  // Pipe assignment, geometry, formats, scaling, blending, pipe CSC, ROI, destination scaling and
+  // bandwidth/clock votes. Buffer handles and fences are left out, they do not affect validation.
+  void AddLayers(const HWLayersInfo &hw_layers_info);
+};
+
+// Bounded, MRU ordered set of configurations which passed the TEST_ONLY commit.
+class ValidateCache {
+ public:
+  // Validates the configuration on hw_intf, unless an identical one passed already. The state
+  // which hw_intf programs on its own on top of hw_layers_info is made part of the key.
+  DisplayError Validate(ValidateKey key, HWInterface *hw_intf, HWLayersInfo *hw_layers_info);
+  void Clear() { validated_configs_.clear(); }
+  size_t Size() const { return validated_configs_.size(); }
+  uint64_t GetHits() const { return hits_; }
+  uint64_t GetMisses() const { return misses_; }
+
+  static const uint32_t kMaxValidatedConfigs = 8;
+
+ private:
+  std::deque<ValidateKey> validated_configs_ = {};
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+};
+
+}  // namespace sdm
+
+#endif  // __VALIDATE_CACHE_H__
@@ -0,0 +1,236 @@
+/*
+* Copyright (c) 2024 The Linux Foundation. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of The Linux Foundation nor the names of its
+*       contributors may be used to endorse or promote products derived
+*       from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+* OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+* IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <utility>
+
+#include "validate_cache.h"
+
+using namespace sdm;
+
+namespace {
+
+// Reports the TEST_ONLY commits and the out of band state, everything else is unused.
+class FakeHWInterface : public HWInterface {
+ public:
+  DisplayError Validate(HWLayersInfo *hw_layers_info) {
+    validate_count++;
+    return validate_error;
+  }
+  DisplayError GetValidateState(uint64_t *state) {
+    *state = hw_state;
+    return hw_state_error;
+  }
+
+  uint32_t validate_count = 0;
+  DisplayError validate_error = kErrorNone;
+  uint64_t hw_state = 0;
+  DisplayError hw_state_error = kErrorNone;
+
+  DisplayError Init() { return kErrorNotSupported; }
+  DisplayError Deinit() { return kErrorNotSupported; }
+  DisplayError GetDisplayId(int32_t *) { return kErrorNotSupported; }
+  DisplayError GetActiveConfig(uint32_t *) { return kErrorNotSupported; }
+  DisplayError GetDefaultConfig(uint32_t *) { return kErrorNotSupported; }
+  DisplayError GetNumDisplayAttributes(uint32_t *) { return kErrorNotSupported; }
+  DisplayError GetDisplayAttributes(uint32_t, HWDisplayAttributes *) { return kErrorNotSupported; }
+  DisplayError GetHWPanelInfo(HWPanelInfo *) { return kErrorNotSupported; }
+  DisplayError SetDisplayAttributes(uint32_t) { return kErrorNotSupported; }
+  DisplayError SetDisplayAttributes(const HWDisplayAttributes &) { return kErrorNotSupported; }
+  DisplayError GetConfigIndex(char *, uint32_t *) { return kErrorNotSupported; }
+  DisplayError PowerOn(const HWQosData &, SyncPoints *) { return kErrorNotSupported; }
+  DisplayError PowerOff(bool, SyncPoints *) { return kErrorNotSupported; }
+  DisplayError Doze(const HWQosData &, SyncPoints *) { return kErrorNotSupported; }
+  DisplayError DozeSuspend(const HWQosData &, SyncPoints *) { return kErrorNotSupported; }
+  DisplayError Standby(SyncPoints *) { return kErrorNotSupported; }
+  DisplayError Commit(HWLayersInfo *) { return kErrorNotSupported; }
+  DisplayError Flush(HWLayersInfo *) { return kErrorNotSupported; }
+  DisplayError GetPPFeaturesVersion(PPFeatureVersion *) { return kErrorNotSupported; }
+  DisplayError SetPPFeature(PPFeatureInfo *) { return kErrorNotSupported; }
+  DisplayError SetVSyncState(bool) { return kErrorNotSupported; }
+  void SetIdleTimeoutMs(uint32_t) { }
+  DisplayError SetDisplayMode(const HWDisplayMode) { return kErrorNotSupported; }
+  DisplayError SetRefreshRate(uint32_t) { return kErrorNotSupported; }
+  DisplayError SetPanelBrightness(int) { return kErrorNotSupported; }
+  DisplayError GetHWScanInfo(HWScanInfo *) { return kErrorNotSupported; }
+  DisplayError GetVideoFormat(uint32_t, uint32_t *) { return kErrorNotSupported; }
+  DisplayError GetMaxCEAFormat(uint32_t *) { return kErrorNotSupported; }
+  DisplayError SetCursorPosition(HWLayersInfo *, int, int) { return kErrorNotSupported; }
+  DisplayError OnMinHdcpEncryptionLevelChange(uint32_t) { return kErrorNotSupported; }
+  DisplayError GetPanelBrightness(int *) { return kErrorNotSupported; }
+  DisplayError SetAutoRefresh(bool) { return kErrorNotSupported; }
+  DisplayError SetScaleLutConfig(HWScaleLutInfo *) { return kErrorNotSupported; }
+  DisplayError UnsetScaleLutConfig() { return kErrorNotSupported; }
+  DisplayError SetMixerAttributes(const HWMixerAttributes &) { return kErrorNotSupported; }
+  DisplayError GetMixerAttributes(HWMixerAttributes *) { return kErrorNotSupported; }
+  DisplayError DumpDebugData() { return kErrorNotSupported; }
+  DisplayError SetDppsFeature(void *, size_t) { return kErrorNotSupported; }
+  DisplayError GetDppsFeatureInfo(void *, size_t) { return kErrorNotSupported; }
+  DisplayError HandleSecureEvent(SecureEvent, const HWQosData &) { return kErrorNotSupported; }
+  DisplayError ControlIdlePowerCollapse(bool, bool) { return kErrorNotSupported; }
+  DisplayError SetDisplayDppsAdROI(void *) { return kErrorNotSupported; }
+  DisplayError SetJitterConfig(uint32_t, float, uint32_t) { return kErrorNotSupported; }
+  DisplayError SetDynamicDSIClock(uint64_t) { return kErrorNotSupported; }
+  DisplayError GetDynamicDSIClock(uint64_t *) { return kErrorNotSupported; }
+  DisplayError GetDisplayIdentificationData(uint8_t *, uint32_t *, uint8_t *) {
+    return kErrorNotSupported;
+  }
+  DisplayError SetFrameTrigger(FrameTriggerMode) { return kErrorNotSupported; }
+  DisplayError SetBLScale(uint32_t) { return kErrorNotSupported; }
+  DisplayError GetPanelBlMaxLvl(uint32_t *) { return kErrorNotSupported; }
+  DisplayError SetPPConfig(void *, size_t) { return kErrorNotSupported; }
+  DisplayError GetPanelBrightnessBasePath(std::string *) const { return kErrorNotSupported; }
+  DisplayError SetBlendSpace(const PrimariesTransfer &) { return kErrorNotSupported; }
+  DisplayError EnableSelfRefresh(SelfRefreshState) { return kErrorNotSupported; }
+  PanelFeaturePropertyIntf *GetPanelFeaturePropertyIntf() { return nullptr; }
+  DisplayError GetFeatureSupportStatus(const HWFeature, uint32_t *) { return kErrorNotSupported; }
+  void FlushConcurrentWriteback() { }
+  DisplayError SetAlternateDisplayConfig(uint32_t *) { return kErrorNotSupported; }
+  DisplayError GetQsyncFps(uint32_t *) { return kErrorNotSupported; }
+  DisplayError UpdateTransferTime(uint32_t) { return kErrorNotSupported; }
+  DisplayError CancelDeferredPowerMode() { return kErrorNotSupported; }
+  void HandleCwbTeardown() { }
+};
+
+class ValidateCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    Layer layer = {};
+    layer.input_buffer.width = 1080;
+    layer.input_buffer.height = 2400;
+    layer.src_rect = {0.0f, 0.0f, 1080.0f, 2400.0f};
+    layer.dst_rect = {0.0f, 0.0f, 1080.0f, 2400.0f};
+    hw_layers_info_.hw_layers.push_back(layer);
+    HWPipeInfo &pipe = hw_layers_info_.config[0].left_pipe;
+    pipe.valid = true;
+    pipe.pipe_id = 1;
+    pipe.src_roi = layer.src_rect;
+    pipe.dst_roi = layer.dst_rect;
+    hw_layers_info_.qos_data.clock_hz = 200000000;
+  }
+
+  DisplayError Validate() {
+    ValidateKey key;
+    key.AddLayers(hw_layers_info_);
+    return cache_.Validate(std::move(key), &hw_intf_, &hw_layers_info_);
+  }
+
+  FakeHWInterface hw_intf_;
+  HWLayersInfo hw_layers_info_;
+  ValidateCache cache_;
+};
+
+TEST_F(ValidateCacheTest, IdenticalConfigurationHits) {
+  EXPECT_EQ(Validate(), kErrorNone);
+  EXPECT_EQ(Validate(), kErrorNone);
+  EXPECT_EQ(hw_intf_.validate_count, 1u);
+  EXPECT_EQ(cache_.GetHits(), 1u);
+  EXPECT_EQ(cache_.GetMisses(), 1u);
+}
+
+TEST_F(ValidateCacheTest, ChangedGeometryMisses) {
+  EXPECT_EQ(Validate(), kErrorNone);
+  hw_layers_info_.config[0].left_pipe.dst_roi.right = 540.0f;
+  EXPECT_EQ(Validate(), kErrorNone);
+  EXPECT_EQ(hw_intf_.validate_count, 2u);
+
+  // Both configurations are remembered.
+  hw_layers_info_.config[0].left_pipe.dst_roi.right = 1080.0f;
+  EXPECT_EQ(Validate(), kErrorNone);
+  EXPECT_EQ(hw_intf_.validate_count, 2u);
+  EXPECT_EQ(cache_.Size(), 2u);
+}
+
+TEST_F(ValidateCacheTest, NewBufferHits) {
+  EXPECT_EQ(Validate(), kErrorNone);
+  hw_layers_info_.hw_layers.at(0).flags.buffer_updated = 1;
+  EXPECT_EQ(Validate(), kErrorNone);
+  EXPECT_EQ(hw_intf_.validate_count, 1u);
+  EXPECT_EQ(cache_.GetHits(), 1u);
+}
+
+TEST_F(ValidateCacheTest, ChangedVotesMiss) {
+  EXPECT_EQ(Validate(), kErrorNone);
+  hw_layers_info_.qos_data.core_ib_bps = 1000000;
+  EXPECT_EQ(Validate(), kErrorNone);
+  EXPECT_EQ(hw_intf_.validate_count, 2u);
+}
+
+TEST_F(ValidateCacheTest, ChangedHWStateMisses) {
+  EXPECT_EQ(Validate(), kErrorNone);
+  // E.g. idle power collapse or a VM release request pending on the next commit.
+  hw_intf_.hw_state = 1;
+  EXPECT_EQ(Validate(), kErrorNone);
+  EXPECT_EQ(hw_intf_.validate_count, 2u);
+}
+
+TEST_F(ValidateCacheTest, UnknownHWStateIsNotCached) {
+  hw_intf_.hw_state_error = kErrorNotSupported;
+  EXPECT_EQ(Validate(), kErrorNone);
+  EXPECT_EQ(Validate(), kErrorNone);
+  EXPECT_EQ(hw_intf_.validate_count, 2u);
+  EXPECT_EQ(cache_.Size(), 0u);
+}
+
+TEST_F(ValidateCacheTest, FailureClearsCache) {
+  EXPECT_EQ(Validate(), kErrorNone);
+  hw_layers_info_.config[0].left_pipe.pipe_id = 2;
+  hw_intf_.validate_error = kErrorHardware;
+  EXPECT_EQ(Validate(), kErrorHardware);
+  EXPECT_EQ(cache_.Size(), 0u);
+
+  hw_intf_.validate_error = kErrorNone;
+  hw_layers_info_.config[0].left_pipe.pipe_id = 1;
+  EXPECT_EQ(Validate(), kErrorNone);
+  EXPECT_EQ(hw_intf_.validate_count, 3u);
+}
+
+TEST_F(ValidateCacheTest, CapacityEvictsLeastRecentlyUsed) {
+  for (uint32_t i = 0; i <= ValidateCache::kMaxValidatedConfigs; i++) {
+    hw_layers_info_.config[0].left_pipe.pipe_id = i;
+    EXPECT_EQ(Validate(), kErrorNone);
+  }
+  EXPECT_EQ(cache_.Size(), size_t(ValidateCache::kMaxValidatedConfigs));
+
+  // The first configuration was dropped, the last one is still known.
+  hw_layers_info_.config[0].left_pipe.pipe_id = 0;
+  EXPECT_EQ(Validate(), kErrorNone);
+  EXPECT_EQ(hw_intf_.validate_count, ValidateCache::kMaxValidatedConfigs + 2);
+  hw_layers_info_.config[0].left_pipe.pipe_id = ValidateCache::kMaxValidatedConfigs;
+  EXPECT_EQ(Validate(), kErrorNone);
+  EXPECT_EQ(hw_intf_.validate_count, ValidateCache::kMaxValidatedConfigs + 2);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
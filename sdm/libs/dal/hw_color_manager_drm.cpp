@@ -70,6 +70,7 @@
 #include <cstring>
 #include <vector>
 #include <new>
+#include <utility>
 
 #ifdef PP_DRM_ENABLE
 #include <display/drm/msm_drm_pp.h>
@@ -158,8 +159,8 @@ static const std::array<const DrmPPFeatureMap *,
   {&g_dspp_map, &g_vig_map, &g_dgm_map}
 };
 
-DisplayError (*HWColorManagerDrm::pp_features_[])(const PPFeatureInfo &,
-                                                    DRMPPFeatureInfo *) = {
+DisplayError (HWColorManagerDrm::*HWColorManagerDrm::pp_features_[])(const PPFeatureInfo &,
+                                                                     DRMPPFeatureInfo *) = {
   [kFeaturePcc] = &HWColorManagerDrm::GetDrmPCC,
   [kFeatureIgc] = &HWColorManagerDrm::GetDrmIGC,
   [kFeaturePgc] = &HWColorManagerDrm::GetDrmPGC,
@@ -285,7 +286,7 @@ DisplayError HWColorManagerDrm::GetDrmFeature(PPFeatureInfo *in_data,
   }
 
   if (pp_features_[out_data->id])
-    ret = pp_features_[out_data->id](*in_data, out_data);
+    ret = (this->*pp_features_[out_data->id])(*in_data, out_data);
 
 
   /* Restore the original enable_flags_ */
@@ -298,6 +299,11 @@ DisplayError HWColorManagerDrm::GetDrmFeature(PPFeatureInfo *in_data,
 
 void HWColorManagerDrm::FreeDrmFeatureData(DRMPPFeatureInfo *feature) {
   if (feature && feature->payload) {
+    if (ReleasePayload(feature->id, feature->payload)) {
+      feature->payload = nullptr;
+      return;
+    }
+
 #ifdef PP_DRM_ENABLE
     void *ptr = feature->payload;
 #endif
@@ -386,6 +392,94 @@ void HWColorManagerDrm::FreeDrmFeatureData(DRMPPFeatureInfo *feature) {
   }
 }
 
+template <typename T>
+T *HWColorManagerDrm::AllocPayload(DRMPPFeatureID id) {
+  if (id < kPPFeaturesMax) {
+    std::lock_guard<std::mutex> lock(payload_lock_);
+    PayloadBuffer &buffer = payload_pool_[id];
+    // A payload still held by another caller gets a one-off allocation instead.
+    if (!buffer.in_use) {
+      size_t size = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+      if (buffer.size < size) {
+        buffer.data.reset(new (std::nothrow) uint64_t[size]);
+        buffer.size = buffer.data ? size : 0;
+      }
+      if (buffer.data) {
+        buffer.in_use = true;
+        return new (buffer.data.get()) T();
+      }
+    }
+  }
+
+  return new (std::nothrow) T();
+}
+
+bool HWColorManagerDrm::ReleasePayload(DRMPPFeatureID id, void *payload) {
+  if (id >= kPPFeaturesMax) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(payload_lock_);
+  PayloadBuffer &buffer = payload_pool_[id];
+  if (!buffer.in_use || payload != buffer.data.get()) {
+    return false;
+  }
+  buffer.in_use = false;
+
+  return true;
+}
+
+bool HWColorManagerDrm::IsFeatureProgrammed(uint32_t obj_id, const DRMPPFeatureInfo &feature) {
+  if (feature.id >= kPPFeaturesMax) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(payload_lock_);
+  ProgrammedFeature &programmed = programmed_[feature.id];
+  const uint8_t *payload = reinterpret_cast<const uint8_t *>(feature.payload);
+  bool has_payload = (payload != nullptr);
+  size_t size = has_payload ? feature.payload_size : 0;
+  if (programmed.valid && programmed.obj_id == obj_id && programmed.version == feature.version &&
+      programmed.has_payload == has_payload && programmed.payload.size() == size &&
+      (!size || !std::memcmp(programmed.payload.data(), payload, size))) {
+    return true;
+  }
+
+  ProgrammedFeature &staged = staged_[feature.id];
+  staged.valid = true;
+  staged.obj_id = obj_id;
+  staged.version = feature.version;
+  staged.has_payload = has_payload;
+  staged.payload.assign(payload, payload + size);
+
+  return false;
+}
+
+void HWColorManagerDrm::CommitProgrammedFeatures() {
+  std::lock_guard<std::mutex> lock(payload_lock_);
+  for (uint32_t i = 0; i < kPPFeaturesMax; i++) {
+    if (staged_[i].valid) {
+      std::swap(programmed_[i], staged_[i]);
+      staged_[i].valid = false;
+    }
+  }
+}
+
+void HWColorManagerDrm::DiscardStagedFeatures() {
+  std::lock_guard<std::mutex> lock(payload_lock_);
+  for (auto &staged : staged_) {
+    staged.valid = false;
+  }
+}
+
+void HWColorManagerDrm::ResetProgrammedFeatures() {
+  std::lock_guard<std::mutex> lock(payload_lock_);
+  for (uint32_t i = 0; i < kPPFeaturesMax; i++) {
+    programmed_[i].valid = false;
+    staged_[i].valid = false;
+  }
+}
+
 DisplayError HWColorManagerDrm::GetDrmPCC(const PPFeatureInfo &in_data,
                                           DRMPPFeatureInfo *out_data) {
   DisplayError ret = kErrorNone;
@@ -418,7 +512,7 @@ DisplayError HWColorManagerDrm::GetDrmPCC(const PPFeatureInfo &in_data,
     return kErrorParameters;
   }
 
-  mdp_pcc = new drm_msm_pcc();
+  mdp_pcc = AllocPayload<drm_msm_pcc>(out_data->id);
   if (!mdp_pcc) {
     DLOGE("Failed to allocate memory for pcc");
     return kErrorMemory;
@@ -501,7 +595,7 @@ DisplayError HWColorManagerDrm::GetDrmIGC(const PPFeatureInfo &in_data,
     return kErrorParameters;
   }
 
-  mdp_igc = new drm_msm_igc_lut();
+  mdp_igc = AllocPayload<drm_msm_igc_lut>(out_data->id);
   if (!mdp_igc) {
     DLOGE("Failed to allocate memory for igc");
     return kErrorMemory;
@@ -516,8 +610,8 @@ DisplayError HWColorManagerDrm::GetDrmIGC(const PPFeatureInfo &in_data,
 
   if (!c0_c1_data_ptr || !c2_data_ptr) {
     DLOGE("Invaid igc data pointer");
-    delete mdp_igc;
-    out_data->payload = NULL;
+    out_data->payload = mdp_igc;
+    FreeDrmFeatureData(out_data);
     return kErrorParameters;
   }
 
@@ -558,7 +652,7 @@ DisplayError HWColorManagerDrm::GetDrmPGC(const PPFeatureInfo &in_data,
     return kErrorParameters;
   }
 
-  mdp_pgc = new drm_msm_pgc_lut();
+  mdp_pgc = AllocPayload<drm_msm_pgc_lut>(out_data->id);
   if (!mdp_pgc) {
     DLOGE("Failed to allocate memory for pgc");
     return kErrorMemory;
@@ -618,7 +712,7 @@ DisplayError HWColorManagerDrm::GetDrmPAHsic(const PPFeatureInfo &in_data,
     return ret;
   }
 
-  mdp_hsic = new drm_msm_pa_hsic();
+  mdp_hsic = AllocPayload<drm_msm_pa_hsic>(out_data->id);
   if (!mdp_hsic) {
     DLOGE("Failed to allocate memory for pa hsic");
     return kErrorMemory;
@@ -648,7 +742,8 @@ DisplayError HWColorManagerDrm::GetDrmPAHsic(const PPFeatureInfo &in_data,
     out_data->payload_size = sizeof(struct drm_msm_pa_hsic);
   } else {
     /* PA HSIC configuration unchanged, no better return code available */
-    delete mdp_hsic;
+    out_data->payload = mdp_hsic;
+    FreeDrmFeatureData(out_data);
     ret = kErrorPermission;
   }
 #endif
@@ -691,7 +786,7 @@ DisplayError HWColorManagerDrm::GetDrmPASixZone(const PPFeatureInfo &in_data,
         return kErrorParameters;
     }
 
-    mdp_sixzone = new drm_msm_sixzone();
+    mdp_sixzone = AllocPayload<drm_msm_sixzone>(out_data->id);
     if (!mdp_sixzone) {
       DLOGE("Failed to allocate memory for six zone");
       return kErrorMemory;
@@ -772,7 +867,7 @@ DisplayError HWColorManagerDrm::GetDrmPAMemColSkin(const PPFeatureInfo &in_data,
     struct drm_msm_memcol *mdp_memcol = NULL;
     struct SDEPaMemColorData *pa_memcol = &sde_pa->skin;
 
-    mdp_memcol = new drm_msm_memcol();
+    mdp_memcol = AllocPayload<drm_msm_memcol>(out_data->id);
     if (!mdp_memcol) {
       DLOGE("Failed to allocate memory for memory color skin");
       return kErrorMemory;
@@ -829,7 +924,7 @@ DisplayError HWColorManagerDrm::GetDrmPAMemColSky(const PPFeatureInfo &in_data,
     struct drm_msm_memcol *mdp_memcol = NULL;
     struct SDEPaMemColorData *pa_memcol = &sde_pa->sky;
 
-    mdp_memcol = new drm_msm_memcol();
+    mdp_memcol = AllocPayload<drm_msm_memcol>(out_data->id);
     if (!mdp_memcol) {
       DLOGE("Failed to allocate memory for memory color sky");
       return kErrorMemory;
@@ -886,7 +981,7 @@ DisplayError HWColorManagerDrm::GetDrmPAMemColFoliage(const PPFeatureInfo &in_da
     struct drm_msm_memcol *mdp_memcol = NULL;
     struct SDEPaMemColorData *pa_memcol = &sde_pa->foliage;
 
-    mdp_memcol = new drm_msm_memcol();
+    mdp_memcol = AllocPayload<drm_msm_memcol>(out_data->id);
     if (!mdp_memcol) {
       DLOGE("Failed to allocate memory for memory color foliage");
       return kErrorMemory;
@@ -941,7 +1036,7 @@ DisplayError HWColorManagerDrm::GetDrmPAMemColProt(const PPFeatureInfo &in_data,
     return ret;
   }
 
-  mdp_memcol = new drm_msm_memcol();
+  mdp_memcol = AllocPayload<drm_msm_memcol>(out_data->id);
   if (!mdp_memcol) {
     DLOGE("Failed to allocate memory for memory color prot");
     return kErrorMemory;
@@ -980,7 +1075,7 @@ DisplayError HWColorManagerDrm::GetDrmDither(const PPFeatureInfo &in_data,
     return kErrorParameters;
   }
 
-  mdp_dither = new drm_msm_dither();
+  mdp_dither = AllocPayload<drm_msm_dither>(out_data->id);
   if (!mdp_dither) {
     DLOGE("Failed to allocate memory for dither");
     return kErrorMemory;
@@ -1025,7 +1120,7 @@ DisplayError HWColorManagerDrm::GetDrmGamut(const PPFeatureInfo &in_data,
     return kErrorParameters;
   }
 
-  mdp_gamut = new(std::nothrow) drm_msm_3d_gamut();
+  mdp_gamut = AllocPayload<drm_msm_3d_gamut>(out_data->id);
   if (!mdp_gamut) {
     DLOGE("Failed to allocate memory for gamut");
     return kErrorMemory;
@@ -1051,7 +1146,8 @@ DisplayError HWColorManagerDrm::GetDrmGamut(const PPFeatureInfo &in_data,
       break;
     default:
       DLOGE("Invalid gamut mode %d", sde_gamut->mode);
-      delete mdp_gamut;
+      out_data->payload = mdp_gamut;
+      FreeDrmFeatureData(out_data);
       return kErrorParameters;
   }
 
@@ -1102,7 +1198,7 @@ DisplayError HWColorManagerDrm::GetDrmPADither(const PPFeatureInfo &in_data,
     return kErrorParameters;
   }
 
-  mdp_dither = new drm_msm_pa_dither();
+  mdp_dither = AllocPayload<drm_msm_pa_dither>(out_data->id);
   if (!mdp_dither) {
     DLOGE("Failed to allocate memory for dither");
     return kErrorMemory;
@@ -32,6 +32,8 @@
 
 #include <drm_interface.h>
 #include <private/color_params.h>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 using sde_drm::DRMPPFeatureID;
@@ -78,27 +80,56 @@ class HWColorManagerDrm {
   uint32_t GetFeatureVersion(const DRMPPFeatureInfo &feature);
   DisplayError ToDrmFeatureId(const PPBlock block, const uint32_t id,
                               std::vector<DRMPPFeatureID> *drm_id);
+  // Returns true if |feature| matches what was last committed for its id on object |obj_id|,
+  // otherwise stages it until the atomic commit carrying it succeeds.
+  bool IsFeatureProgrammed(uint32_t obj_id, const DRMPPFeatureInfo &feature);
+  // Promotes the staged features once the commit carrying them has reached the hardware.
+  void CommitProgrammedFeatures();
+  // Drops the staged features, e.g. when the atomic request holding them is reset.
+  void DiscardStagedFeatures();
+  // Forgets the programmed state, e.g. when a commit carrying it did not reach the hardware.
+  void ResetProgrammedFeatures();
   HWColorManagerDrm() {}
   ~HWColorManagerDrm() {}
 
  private:
-  static DisplayError GetDrmPCC(const PPFeatureInfo &in_data, DRMPPFeatureInfo *out_data);
-  static DisplayError GetDrmIGC(const PPFeatureInfo &in_data, DRMPPFeatureInfo *out_data);
-  static DisplayError GetDrmPGC(const PPFeatureInfo &in_data, DRMPPFeatureInfo *out_data);
-  static DisplayError GetDrmMixerGC(const PPFeatureInfo &in_data, DRMPPFeatureInfo *out_data);
-  static DisplayError GetDrmDither(const PPFeatureInfo &in_data, DRMPPFeatureInfo *out_data);
-  static DisplayError GetDrmGamut(const PPFeatureInfo &in_data, DRMPPFeatureInfo *out_data);
-  static DisplayError GetDrmPADither(const PPFeatureInfo &in_data, DRMPPFeatureInfo *out_data);
-  static DisplayError GetDrmPAHsic(const PPFeatureInfo &in_data, DRMPPFeatureInfo *out_data);
-  static DisplayError GetDrmPASixZone(const PPFeatureInfo &in_data, DRMPPFeatureInfo *out_data);
-  static DisplayError GetDrmPAMemColSkin(const PPFeatureInfo &in_data, DRMPPFeatureInfo *out_data);
-  static DisplayError GetDrmPAMemColSky(const PPFeatureInfo &in_data, DRMPPFeatureInfo *out_data);
-  static DisplayError GetDrmPAMemColFoliage(const PPFeatureInfo &in_data,
-                                            DRMPPFeatureInfo *out_data);
-  static DisplayError GetDrmPAMemColProt(const PPFeatureInfo &in_data, DRMPPFeatureInfo *out_data);
+  DisplayError GetDrmPCC(const PPFeatureInfo &in_data, DRMPPFeatureInfo *out_data);
+  DisplayError GetDrmIGC(const PPFeatureInfo &in_data, DRMPPFeatureInfo *out_data);
+  DisplayError GetDrmPGC(const PPFeatureInfo &in_data, DRMPPFeatureInfo *out_data);
+  DisplayError GetDrmMixerGC(const PPFeatureInfo &in_data, DRMPPFeatureInfo *out_data);
+  DisplayError GetDrmDither(const PPFeatureInfo &in_data, DRMPPFeatureInfo *out_data);
+  DisplayError GetDrmGamut(const PPFeatureInfo &in_data, DRMPPFeatureInfo *out_data);
+  DisplayError GetDrmPADither(const PPFeatureInfo &in_data, DRMPPFeatureInfo *out_data);
+  DisplayError GetDrmPAHsic(const PPFeatureInfo &in_data, DRMPPFeatureInfo *out_data);
+  DisplayError GetDrmPASixZone(const PPFeatureInfo &in_data, DRMPPFeatureInfo *out_data);
+  DisplayError GetDrmPAMemColSkin(const PPFeatureInfo &in_data, DRMPPFeatureInfo *out_data);
+  DisplayError GetDrmPAMemColSky(const PPFeatureInfo &in_data, DRMPPFeatureInfo *out_data);
+  DisplayError GetDrmPAMemColFoliage(const PPFeatureInfo &in_data, DRMPPFeatureInfo *out_data);
+  DisplayError GetDrmPAMemColProt(const PPFeatureInfo &in_data, DRMPPFeatureInfo *out_data);
+  template <typename T>
+  T *AllocPayload(DRMPPFeatureID id);
+  bool ReleasePayload(DRMPPFeatureID id, void *payload);
 
-  static DisplayError (*pp_features_[kPPFeaturesMax])(const PPFeatureInfo &in_data,
-                                                      DRMPPFeatureInfo *out_data);
+  static DisplayError (HWColorManagerDrm::*pp_features_[kPPFeaturesMax])(
+      const PPFeatureInfo &in_data, DRMPPFeatureInfo *out_data);
+
+  // Kernel payload of each feature, reused across conversions instead of allocated per call.
+  struct PayloadBuffer {
+    std::unique_ptr<uint64_t[]> data = {};
+    size_t size = 0;
+    bool in_use = false;
+  };
+  struct ProgrammedFeature {
+    bool valid = false;
+    uint32_t obj_id = 0;
+    uint32_t version = 0;
+    bool has_payload = false;
+    std::vector<uint8_t> payload = {};
+  };
+  std::mutex payload_lock_;
+  PayloadBuffer payload_pool_[kPPFeaturesMax] = {};
+  ProgrammedFeature programmed_[kPPFeaturesMax] = {};
+  ProgrammedFeature staged_[kPPFeaturesMax] = {};
 };
 
 }  // namespace sdm
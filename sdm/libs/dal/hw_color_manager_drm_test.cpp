@@ -0,0 +1,123 @@
+/*
+* Copyright (c) 2024 The Linux Foundation. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of The Linux Foundation nor the names of its
+*       contributors may be used to endorse or promote products derived
+*       from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+* OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+* IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "hw_color_manager_drm.h"
+
+using namespace sdm;
+
+namespace {
+
+const uint32_t kCrtcId = 10;
+
+class HWColorManagerDrmTest : public ::testing::Test {
+ protected:
+  HWColorManagerDrmTest() : payload_(64, 0x5a) {
+    feature_.id = kFeaturePcc;
+    feature_.type = sde_drm::kPropBlob;
+    feature_.version = 4;
+    feature_.payload_size = UINT32(payload_.size());
+    feature_.payload = payload_.data();
+  }
+
+  HWColorManagerDrm color_mgr_;
+  std::vector<uint8_t> payload_;
+  DRMPPFeatureInfo feature_ = {};
+};
+
+TEST_F(HWColorManagerDrmTest, StagedFeatureIsProgrammedOnlyAfterCommit) {
+  EXPECT_FALSE(color_mgr_.IsFeatureProgrammed(kCrtcId, feature_));
+  // Still not on the hardware, so it has to be sent again.
+  EXPECT_FALSE(color_mgr_.IsFeatureProgrammed(kCrtcId, feature_));
+
+  color_mgr_.CommitProgrammedFeatures();
+  EXPECT_TRUE(color_mgr_.IsFeatureProgrammed(kCrtcId, feature_));
+}
+
+TEST_F(HWColorManagerDrmTest, DiscardedFeatureIsNotCommitted) {
+  EXPECT_FALSE(color_mgr_.IsFeatureProgrammed(kCrtcId, feature_));
+  color_mgr_.DiscardStagedFeatures();
+  color_mgr_.CommitProgrammedFeatures();
+  EXPECT_FALSE(color_mgr_.IsFeatureProgrammed(kCrtcId, feature_));
+}
+
+TEST_F(HWColorManagerDrmTest, DiscardKeepsProgrammedFeature) {
+  EXPECT_FALSE(color_mgr_.IsFeatureProgrammed(kCrtcId, feature_));
+  color_mgr_.CommitProgrammedFeatures();
+
+  // A different payload is staged, then dropped along with its atomic request.
+  std::vector<uint8_t> other_payload(payload_.size(), 0x11);
+  DRMPPFeatureInfo other = feature_;
+  other.payload = other_payload.data();
+  EXPECT_FALSE(color_mgr_.IsFeatureProgrammed(kCrtcId, other));
+  color_mgr_.DiscardStagedFeatures();
+  color_mgr_.CommitProgrammedFeatures();
+
+  EXPECT_TRUE(color_mgr_.IsFeatureProgrammed(kCrtcId, feature_));
+}
+
+TEST_F(HWColorManagerDrmTest, ChangedFeatureIsReprogrammed) {
+  EXPECT_FALSE(color_mgr_.IsFeatureProgrammed(kCrtcId, feature_));
+  color_mgr_.CommitProgrammedFeatures();
+
+  payload_[payload_.size() - 1]++;
+  EXPECT_FALSE(color_mgr_.IsFeatureProgrammed(kCrtcId, feature_));
+  payload_[payload_.size() - 1]--;
+
+  DRMPPFeatureInfo other_version = feature_;
+  other_version.version = 5;
+  EXPECT_FALSE(color_mgr_.IsFeatureProgrammed(kCrtcId, other_version));
+
+  DRMPPFeatureInfo disabled = feature_;
+  disabled.payload = nullptr;
+  EXPECT_FALSE(color_mgr_.IsFeatureProgrammed(kCrtcId, disabled));
+
+  EXPECT_FALSE(color_mgr_.IsFeatureProgrammed(kCrtcId + 1, feature_));
+  color_mgr_.DiscardStagedFeatures();
+  EXPECT_TRUE(color_mgr_.IsFeatureProgrammed(kCrtcId, feature_));
+}
+
+TEST_F(HWColorManagerDrmTest, ResetForgetsProgrammedFeatures) {
+  EXPECT_FALSE(color_mgr_.IsFeatureProgrammed(kCrtcId, feature_));
+  color_mgr_.CommitProgrammedFeatures();
+
+  // The commit carrying the feature failed, so it is sent again on the next one.
+  color_mgr_.ResetProgrammedFeatures();
+  EXPECT_FALSE(color_mgr_.IsFeatureProgrammed(kCrtcId, feature_));
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
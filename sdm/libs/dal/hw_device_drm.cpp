@@ -436,21 +436,29 @@ void HWDeviceDRM::Registry::MapOutputBufferToFbId(std::shared_ptr<LayerBuffer> o
   uint64_t handle_id = output_buffer->handle_id;
   if (!handle_id || disable_fbid_cache_) {
     // In legacy path, clear output buffer map in each frame.
-    output_buffer_map_.clear();
+    Clear();
   } else {
+    auto order = std::find(output_buffer_order_.begin(), output_buffer_order_.end(), handle_id);
+    if (order != output_buffer_order_.end()) {
+      output_buffer_order_.erase(order);
+    }
+
     auto it = output_buffer_map_.find(handle_id);
     if (it != output_buffer_map_.end()) {
       FrameBufferObject *fb_obj = static_cast<FrameBufferObject*>(it->second.get());
       if (fb_obj->IsEqual(output_buffer->format, output_buffer->width, output_buffer->height)) {
+        output_buffer_order_.push_front(handle_id);
         return;
       } else {
         output_buffer_map_.erase(it);
       }
     }
 
-    if (output_buffer_map_.size() >= UI_FBID_LIMIT) {
-      // Clear output buffer map, if the size reaches cache limit.
-      output_buffer_map_.clear();
+    // Streaming CWB clients cycle through a ring of buffers, so only drop the least recently
+    // used fb_id when the cache is full.
+    while (output_buffer_order_.size() >= UI_FBID_LIMIT) {
+      output_buffer_map_.erase(output_buffer_order_.back());
+      output_buffer_order_.pop_back();
     }
   }
 
@@ -458,11 +466,15 @@ void HWDeviceDRM::Registry::MapOutputBufferToFbId(std::shared_ptr<LayerBuffer> o
   if (CreateFbId(*output_buffer, &fb_id) >= 0) {
     output_buffer_map_[handle_id] = std::make_shared<FrameBufferObject>(fb_id,
         output_buffer->format, output_buffer->width, output_buffer->height);
+    if (handle_id && !disable_fbid_cache_) {
+      output_buffer_order_.push_front(handle_id);
+    }
   }
 }
 
 void HWDeviceDRM::Registry::Clear() {
   output_buffer_map_.clear();
+  output_buffer_order_.clear();
 }
 
 uint32_t HWDeviceDRM::Registry::GetFbId(Layer *layer, uint64_t handle_id) {
@@ -1242,6 +1254,10 @@ DisplayError HWDeviceDRM::PowerOff(bool teardown, SyncPoints *sync_points) {
   pending_power_state_ = kPowerStateNone;
 
   last_power_mode_ = DRMPowerMode::OFF;
+  // Post processing blocks may lose their programming across the power cycle.
+  if (hw_color_mgr_) {
+    hw_color_mgr_->ResetProgrammedFeatures();
+  }
 
   return kErrorNone;
 }
@@ -1788,6 +1804,11 @@ DisplayError HWDeviceDRM::Validate(HWLayersInfo *hw_layers_info) {
   DisplayError err = kErrorNone;
   registry_.Register(hw_layers_info);
 
+  // PP features staged for a request that never got committed are dropped along with it.
+  if (hw_color_mgr_) {
+    hw_color_mgr_->DiscardStagedFeatures();
+  }
+
   Fence::ScopedRef scoped_ref;
   SetupAtomic(scoped_ref, hw_layers_info, true /* validate */, nullptr, nullptr);
 
@@ -1897,6 +1918,9 @@ DisplayError HWDeviceDRM::AtomicCommit(HWLayersInfo *hw_layers_info) {
   if (ret) {
     DLOGE("%s failed with error %d crtc %d", __FUNCTION__, ret, token_.crtc_id);
     DumpHWLayers(hw_layers_info);
+    if (hw_color_mgr_) {
+      hw_color_mgr_->ResetProgrammedFeatures();
+    }
     vrefresh_ = 0;
     panel_mode_changed_ = 0;
     seamless_mode_switch_ = false;
@@ -1905,6 +1929,10 @@ DisplayError HWDeviceDRM::AtomicCommit(HWLayersInfo *hw_layers_info) {
     return kErrorHardware;
   }
 
+  if (hw_color_mgr_) {
+    hw_color_mgr_->CommitProgrammedFeatures();
+  }
+
   DLOGD_IF(kTagDriverConfig, "RELEASE fence: fd: %s", Fence::GetStr(release_fence).c_str());
   DLOGD_IF(kTagDriverConfig, "RETIRE fence: fd: %s", Fence::GetStr(retire_fence).c_str());
 
@@ -2228,12 +2256,17 @@ DisplayError HWDeviceDRM::SetPPFeature(PPFeatureInfo *feature) {
 
     kernel_params.id = id;
     ret = hw_color_mgr_->GetDrmFeature(feature, &kernel_params);
-    if (!ret && crtc_feature)
+    uint32_t obj_id = crtc_feature ? token_.crtc_id : token_.conn_id;
+    if (!ret && hw_color_mgr_->IsFeatureProgrammed(obj_id, kernel_params)) {
+      // Same configuration as already programmed, e.g. unchanged across a color mode switch.
+      DLOGV_IF(kTagDriverConfig, "feature %d unchanged on object %d", id, obj_id);
+    } else if (!ret && crtc_feature) {
       drm_atomic_intf_->Perform(DRMOps::CRTC_SET_POST_PROC,
                                 token_.crtc_id, &kernel_params);
-    else if (!ret && !crtc_feature)
+    } else if (!ret && !crtc_feature) {
       drm_atomic_intf_->Perform(DRMOps::CONNECTOR_SET_POST_PROC,
                                 token_.conn_id, &kernel_params);
+    }
 
     hw_color_mgr_->FreeDrmFeatureData(&kernel_params);
   }
@@ -3244,6 +3277,9 @@ DisplayError HWDeviceDRM::SetPPConfig(void *payload, size_t size) {
   }
 
   struct DRMPPFeatureInfo *info = reinterpret_cast<struct DRMPPFeatureInfo *> (payload);
+  if (hw_color_mgr_) {
+    hw_color_mgr_->ResetProgrammedFeatures();
+  }
 
   if (info->object_type == DRM_MODE_OBJECT_CONNECTOR && token_.conn_id) {
     drm_atomic_intf_->Perform(DRMOps::CONNECTOR_SET_POST_PROC, token_.conn_id, payload);
@@ -3270,4 +3306,9 @@ void HWDeviceDRM::HandleCwbTeardown() {
   pending_cwb_teardown_ = true;
 }
 
+DisplayError HWDeviceDRM::GetValidateState(uint64_t *state) {
+  *state = (UINT64(tui_state_) << 1) | pending_cwb_teardown_;
+  return kErrorNone;
+}
+
 }  // namespace sdm
@@ -43,6 +43,7 @@
 #include <pthread.h>
 #include <xf86drmMode.h>
 #include <atomic>
+#include <deque>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -179,6 +180,7 @@ class HWDeviceDRM : public HWInterface {
   }
   virtual DisplayError CancelDeferredPowerMode();
   virtual void HandleCwbTeardown();
+  virtual DisplayError GetValidateState(uint64_t *state);
 
   enum {
     kHWEventVSync,
@@ -270,6 +272,8 @@ class HWDeviceDRM : public HWInterface {
    private:
     bool disable_fbid_cache_ = false;
     std::unordered_map<uint64_t, std::shared_ptr<LayerBufferObject>> output_buffer_map_ {};
+    // Handle ids of the cached output buffers, most recently used first.
+    std::deque<uint64_t> output_buffer_order_ {};
     BufferAllocator *buffer_allocator_ = {};
     uint8_t fbid_cache_limit_ = UI_FBID_LIMIT;
   };
@@ -77,9 +77,11 @@
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/utsname.h>
 #include <utils/constants.h>
 #include <utils/debug.h>
 #include <utils/sys.h>
+#include <xf86drm.h>
 
 #include <algorithm>
 #include <fstream>
@@ -745,6 +747,218 @@ DisplayError HWInfoDRM::GetRotatorSupportedFormats(uint32_t v4l2_index,
 }
 
 DisplayError HWInfoDRM::GetHWRotatorInfo(HWResourceInfo *hw_resource) {
+  int value = 0;
+  Debug::GetProperty(DISABLE_HW_CAPS_CACHE_PROP, &value);
+  if (value == 1) {
+    return ProbeHWRotatorInfo(hw_resource);
+  }
+
+  // Probing walks all the V4L2 nodes, reuse its outcome across composer restarts as long as the
+  // kernel and display driver did not change.
+  uint64_t key = GetCapsCacheKey();
+  if (LoadRotatorCapsCache(key, hw_resource)) {
+    DLOGI("V4L2 Rotator: Count = %d, Downscale = %d, Min_downscale = %f, " \
+          "Downscale_compression = %d, Max_line_width = %d (cached)",
+          hw_resource->hw_rot_info.num_rotator, hw_resource->hw_rot_info.has_downscale,
+          hw_resource->hw_rot_info.min_downscale, hw_resource->hw_rot_info.downscale_compression,
+          hw_resource->hw_rot_info.max_line_width);
+    return kErrorNone;
+  }
+
+  DisplayError error = ProbeHWRotatorInfo(hw_resource);
+  // An empty probe may just mean the rotator driver has not registered yet, probe again next time.
+  if (error == kErrorNone && hw_resource->hw_rot_info.num_rotator) {
+    StoreRotatorCapsCache(key, *hw_resource);
+  }
+
+  return error;
+}
+
+namespace {
+// FNV-1a, stable across builds unlike std::hash.
+uint64_t HashBytes(const void *data, size_t size, uint64_t hash = 0xcbf29ce484222325ULL) {
+  const uint8_t *bytes = reinterpret_cast<const uint8_t *>(data);
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+uint64_t HashString(const string &str, uint64_t hash) {
+  return HashBytes(str.data(), str.size() + 1, hash);
+}
+
+template <typename T>
+void AppendValue(const T &value, vector<uint8_t> *buf) {
+  const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&value);
+  buf->insert(buf->end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+bool ReadValue(const vector<uint8_t> &buf, size_t *offset, T *value) {
+  if (buf.size() - *offset < sizeof(T)) {
+    return false;
+  }
+  memcpy(value, buf.data() + *offset, sizeof(T));
+  *offset += sizeof(T);
+  return true;
+}
+
+struct CapsCacheHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t key;
+  uint64_t checksum;
+  uint32_t size;
+  uint32_t reserved;
+};
+}  // namespace
+
+uint64_t HWInfoDRM::GetCapsCacheKey() {
+  uint64_t key = HashBytes(&kCapsCacheVersion, sizeof(kCapsCacheVersion));
+
+  struct utsname kernel = {};
+  if (!uname(&kernel)) {
+    key = HashString(kernel.release, key);
+    key = HashString(kernel.version, key);
+  }
+
+  // Vendor updates can change rotator firmware or driver modules without touching the kernel.
+  char fingerprint[kMaxStringLength] = {};
+  if (Debug::GetProperty("ro.vendor.build.fingerprint", fingerprint) == kErrorNone) {
+    key = HashString(fingerprint, key);
+  }
+
+  DRMMaster *drm_master = nullptr;
+  int dev_fd = -1;
+  DRMMaster::GetInstance(&drm_master);
+  if (drm_master) {
+    drm_master->GetHandle(&dev_fd);
+  }
+  drmVersionPtr version = (dev_fd >= 0) ? drmGetVersion(dev_fd) : nullptr;
+  if (version) {
+    key = HashBytes(&version->version_major, sizeof(version->version_major), key);
+    key = HashBytes(&version->version_minor, sizeof(version->version_minor), key);
+    key = HashBytes(&version->version_patchlevel, sizeof(version->version_patchlevel), key);
+    key = HashString(string(version->name, version->name_len), key);
+    key = HashString(string(version->date, version->date_len), key);
+    drmFreeVersion(version);
+  }
+
+  return key;
+}
+
+bool HWInfoDRM::LoadRotatorCapsCache(uint64_t key, HWResourceInfo *hw_resource) {
+  int fd = Sys::open_(kCapsCachePath, O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  CapsCacheHeader header = {};
+  vector<uint8_t> buf;
+  bool valid = (Sys::read_(fd, &header, sizeof(header)) == sizeof(header)) &&
+               (header.magic == kCapsCacheMagic) && (header.version == kCapsCacheVersion) &&
+               (header.key == key) && (header.size <= kMaxStringLength * 4);
+  if (valid) {
+    buf.resize(header.size);
+    valid = (Sys::read_(fd, buf.data(), buf.size()) == ssize_t(buf.size())) &&
+            (HashBytes(buf.data(), buf.size()) == header.checksum);
+  }
+  Sys::close_(fd);
+  if (!valid) {
+    DLOGI("Ignoring stale or corrupt capabilities cache");
+    return false;
+  }
+
+  HWRotatorInfo rot_info = {};
+  uint8_t has_downscale = 0, downscale_compression = 0;
+  uint32_t path_length = 0;
+  size_t offset = 0;
+  valid = ReadValue(buf, &offset, &rot_info.num_rotator) &&
+          ReadValue(buf, &offset, &has_downscale) &&
+          ReadValue(buf, &offset, &downscale_compression) &&
+          ReadValue(buf, &offset, &rot_info.min_downscale) &&
+          ReadValue(buf, &offset, &rot_info.max_line_width) &&
+          ReadValue(buf, &offset, &path_length) && (buf.size() - offset >= path_length);
+  if (!valid) {
+    return false;
+  }
+  rot_info.has_downscale = has_downscale;
+  rot_info.downscale_compression = downscale_compression;
+  rot_info.device_path.assign(reinterpret_cast<const char *>(buf.data() + offset), path_length);
+  offset += path_length;
+
+  FormatsMap formats_map = {};
+  for (HWSubBlockType sub_blk_type : {kHWRotatorInput, kHWRotatorOutput}) {
+    uint32_t count = 0;
+    uint8_t present = 0;
+    if (!ReadValue(buf, &offset, &present) || !ReadValue(buf, &offset, &count)) {
+      return false;
+    }
+    vector<LayerBufferFormat> formats(count);
+    for (LayerBufferFormat &format : formats) {
+      uint32_t sdm_format = 0;
+      if (!ReadValue(buf, &offset, &sdm_format)) {
+        return false;
+      }
+      format = static_cast<LayerBufferFormat>(sdm_format);
+    }
+    if (present) {
+      formats_map.insert(make_pair(sub_blk_type, formats));
+    }
+  }
+
+  hw_resource->hw_rot_info = rot_info;
+  for (auto &it : formats_map) {
+    hw_resource->supported_formats_map.erase(it.first);
+    hw_resource->supported_formats_map.insert(it);
+  }
+
+  return true;
+}
+
+void HWInfoDRM::StoreRotatorCapsCache(uint64_t key, const HWResourceInfo &hw_resource) {
+  const HWRotatorInfo &rot_info = hw_resource.hw_rot_info;
+  vector<uint8_t> buf;
+  AppendValue(rot_info.num_rotator, &buf);
+  AppendValue(uint8_t(rot_info.has_downscale), &buf);
+  AppendValue(uint8_t(rot_info.downscale_compression), &buf);
+  AppendValue(rot_info.min_downscale, &buf);
+  AppendValue(rot_info.max_line_width, &buf);
+  AppendValue(UINT32(rot_info.device_path.size()), &buf);
+  buf.insert(buf.end(), rot_info.device_path.begin(), rot_info.device_path.end());
+  for (HWSubBlockType sub_blk_type : {kHWRotatorInput, kHWRotatorOutput}) {
+    auto it = hw_resource.supported_formats_map.find(sub_blk_type);
+    bool present = (it != hw_resource.supported_formats_map.end());
+    AppendValue(uint8_t(present), &buf);
+    AppendValue(present ? UINT32(it->second.size()) : 0U, &buf);
+    if (present) {
+      for (LayerBufferFormat format : it->second) {
+        AppendValue(UINT32(format), &buf);
+      }
+    }
+  }
+
+  CapsCacheHeader header = {kCapsCacheMagic, kCapsCacheVersion, key,
+                            HashBytes(buf.data(), buf.size()), UINT32(buf.size()), 0};
+
+  // Write a temporary file and rename it, so that a crash never leaves a partial cache behind.
+  string tmp_path = string(kCapsCachePath) + ".tmp";
+  int fd = Sys::open_(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0660);
+  if (fd < 0) {
+    DLOGW("Failed to create %s, error %d", tmp_path.c_str(), errno);
+    return;
+  }
+  bool written = (Sys::write_(fd, &header, sizeof(header)) == sizeof(header)) &&
+                 (Sys::write_(fd, buf.data(), buf.size()) == ssize_t(buf.size()));
+  Sys::close_(fd);
+  if (!written || rename(tmp_path.c_str(), kCapsCachePath)) {
+    DLOGW("Failed to write %s, error %d", kCapsCachePath, errno);
+    unlink(tmp_path.c_str());
+  }
+}
+
+DisplayError HWInfoDRM::ProbeHWRotatorInfo(HWResourceInfo *hw_resource) {
   string v4l2_path = "/sys/class/video4linux/video";
   const uint32_t kMaxV4L2Nodes = 64;
 
@@ -61,6 +61,10 @@ class HWInfoDRM : public HWInfoInterface {
  private:
   void Deinit();
   DisplayError GetHWRotatorInfo(HWResourceInfo *hw_resource);
+  DisplayError ProbeHWRotatorInfo(HWResourceInfo *hw_resource);
+  uint64_t GetCapsCacheKey();
+  bool LoadRotatorCapsCache(uint64_t key, HWResourceInfo *hw_resource);
+  void StoreRotatorCapsCache(uint64_t key, const HWResourceInfo &hw_resource);
   void GetSystemInfo(HWResourceInfo *hw_resource);
   void GetHWPlanesInfo(HWResourceInfo *hw_resource);
   void GetWBInfo(HWResourceInfo *hw_resource);
@@ -85,6 +89,9 @@ class HWInfoDRM : public HWInfoInterface {
 
   static const int kMaxStringLength = 1024;
   static const int kKiloUnit = 1000;
+  static constexpr const char *kCapsCachePath = "/data/vendor/display/hw_caps_cache.bin";
+  static constexpr uint32_t kCapsCacheMagic = 0x53444d43;  // "SDMC"
+  static constexpr uint32_t kCapsCacheVersion = 1;
 
   static HWResourceInfo *hw_resource_;
 };
@@ -210,6 +210,13 @@ DisplayError HWPeripheralDRM::UpdateTransferTime(uint32_t transfer_time) {
   return error;
 }
 
+DisplayError HWPeripheralDRM::GetValidateState(uint64_t *state) {
+  HWDeviceDRM::GetValidateState(state);
+  *state |= (UINT64(idle_pc_state_) << 40) | (UINT64(self_refresh_state_) << 32);
+
+  return kErrorNone;
+}
+
 DisplayError HWPeripheralDRM::Validate(HWLayersInfo *hw_layers_info) {
   SetDestScalarData(*hw_layers_info);
   SetIdlePCState();
@@ -112,6 +112,7 @@ class HWPeripheralDRM : public HWDeviceDRM, public PanelFeaturePropertyIntf {
   virtual DisplayError EnableSelfRefresh(SelfRefreshState self_refresh_state);
   virtual DisplayError SetAlternateDisplayConfig(uint32_t *alt_config);
   virtual DisplayError UpdateTransferTime(uint32_t transfer_time);
+  virtual DisplayError GetValidateState(uint64_t *state);
 
  private:
   void InitDestScaler();
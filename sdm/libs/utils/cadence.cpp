@@ -0,0 +1,85 @@
+/*
+* Copyright (c) 2024 The Linux Foundation. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of The Linux Foundation nor the names of its
+*       contributors may be used to endorse or promote products derived
+*       from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+* OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+* IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <utils/cadence.h>
+#include <math.h>
+
+namespace sdm {
+
+static const uint32_t kStandardFrameRates[] = {24, 25, 30, 48, 50, 60};
+// Relative deviation tolerated between the measured and the standard rate.
+static const double kRateTolerance = 0.02;
+// Bounds of a single interval relative to the window average. Pulldown intervals stay within
+// them, windows mixing two cadences do not.
+static const double kMinIntervalRatio = 0.5;
+static const double kMaxIntervalRatio = 2.0;
+
+void CadenceEstimator::AddTimestamp(int64_t timestamp_ns) {
+  if (!timestamps_.empty()) {
+    int64_t interval = timestamp_ns - timestamps_.back();
+    if (interval <= 0) {
+      return;
+    }
+    if (interval > kMaxIntervalNs) {
+      timestamps_.clear();
+    }
+  }
+
+  timestamps_.push_back(timestamp_ns);
+  if (timestamps_.size() > kMaxSamples) {
+    timestamps_.pop_front();
+  }
+}
+
+uint32_t CadenceEstimator::GetFrameRate() const {
+  if (timestamps_.size() < kMinSamples) {
+    return 0;
+  }
+
+  double span = static_cast<double>(timestamps_.back() - timestamps_.front());
+  double mean_interval = span / static_cast<double>(timestamps_.size() - 1);
+  for (size_t i = 1; i < timestamps_.size(); i++) {
+    double interval = static_cast<double>(timestamps_[i] - timestamps_[i - 1]);
+    if (interval < (mean_interval * kMinIntervalRatio) ||
+        interval > (mean_interval * kMaxIntervalRatio)) {
+      return 0;
+    }
+  }
+
+  double rate = 1000000000.0 / mean_interval;
+  for (uint32_t standard_rate : kStandardFrameRates) {
+    if (fabs(rate - standard_rate) <= (standard_rate * kRateTolerance)) {
+      return standard_rate;
+    }
+  }
+
+  return 0;
+}
+
+}  // namespace sdm
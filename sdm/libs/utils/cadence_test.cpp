@@ -0,0 +1,147 @@
+/*
+* Copyright (c) 2024 The Linux Foundation. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of The Linux Foundation nor the names of its
+*       contributors may be used to endorse or promote products derived
+*       from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+* OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+* IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+#include <utils/cadence.h>
+#include <math.h>
+
+#include <random>
+#include <vector>
+
+using namespace sdm;
+
+namespace {
+
+const int64_t kNsPerSec = 1000000000;
+
+// Feeds buffer changes of content at content_fps latched on the vsyncs of a panel at panel_hz,
+// as a compositor does. Timestamps land on the first vsync at or after each content frame.
+void FeedLatched(CadenceEstimator *estimator, double content_fps, double panel_hz,
+                 uint32_t frames, int64_t start_ns = 0) {
+  double vsync_ns = kNsPerSec / panel_hz;
+  for (uint32_t i = 0; i < frames; i++) {
+    double frame_ns = i * (kNsPerSec / content_fps);
+    double vsync = ceil(frame_ns / vsync_ns - 1e-6);
+    estimator->AddTimestamp(start_ns + static_cast<int64_t>(vsync * vsync_ns));
+  }
+}
+
+}  // namespace
+
+TEST(CadenceEstimatorTest, NeedsMinimumSamples) {
+  CadenceEstimator estimator;
+  FeedLatched(&estimator, 30, 60, 10);
+  EXPECT_EQ(estimator.GetFrameRate(), 0u);
+}
+
+TEST(CadenceEstimatorTest, DetectsPanelRate) {
+  CadenceEstimator estimator;
+  FeedLatched(&estimator, 60, 60, 60);
+  EXPECT_EQ(estimator.GetFrameRate(), 60u);
+}
+
+TEST(CadenceEstimatorTest, DetectsStandardRatesOn60Hz) {
+  for (uint32_t fps : {24u, 25u, 30u, 48u, 50u}) {
+    CadenceEstimator estimator;
+    FeedLatched(&estimator, fps, 60, 100);
+    EXPECT_EQ(estimator.GetFrameRate(), fps) << "content fps " << fps;
+  }
+}
+
+TEST(CadenceEstimatorTest, DetectsStandardRatesOn120Hz) {
+  for (uint32_t fps : {24u, 25u, 30u, 48u, 50u, 60u}) {
+    CadenceEstimator estimator;
+    FeedLatched(&estimator, fps, 120, 100);
+    EXPECT_EQ(estimator.GetFrameRate(), fps) << "content fps " << fps;
+  }
+}
+
+TEST(CadenceEstimatorTest, ToleratesTimestampJitter) {
+  CadenceEstimator estimator;
+  std::mt19937 engine(7);
+  std::uniform_int_distribution<int64_t> jitter(-2000000, 2000000);
+  int64_t period = kNsPerSec / 30;
+  for (int64_t i = 0; i < 100; i++) {
+    estimator.AddTimestamp(kNsPerSec + i * period + jitter(engine));
+  }
+  EXPECT_EQ(estimator.GetFrameRate(), 30u);
+}
+
+TEST(CadenceEstimatorTest, RejectsNonStandardRate) {
+  CadenceEstimator estimator;
+  FeedLatched(&estimator, 40, 120, 100);
+  EXPECT_EQ(estimator.GetFrameRate(), 0u);
+}
+
+TEST(CadenceEstimatorTest, RejectsMixedCadence) {
+  CadenceEstimator estimator;
+  int64_t t = 0;
+  for (int i = 0; i < 60; i++) {
+    t += (i % 4) ? (kNsPerSec / 60) : (kNsPerSec / 10);
+    estimator.AddTimestamp(t);
+  }
+  EXPECT_EQ(estimator.GetFrameRate(), 0u);
+}
+
+TEST(CadenceEstimatorTest, FollowsRateChange) {
+  CadenceEstimator estimator;
+  FeedLatched(&estimator, 60, 60, 60);
+  EXPECT_EQ(estimator.GetFrameRate(), 60u);
+
+  // While the window holds both rates there is no stable estimate.
+  FeedLatched(&estimator, 30, 60, 10, kNsPerSec + kNsPerSec / 30);
+  EXPECT_EQ(estimator.GetFrameRate(), 0u);
+
+  FeedLatched(&estimator, 30, 60, 60, kNsPerSec + kNsPerSec / 30);
+  EXPECT_EQ(estimator.GetFrameRate(), 30u);
+}
+
+TEST(CadenceEstimatorTest, StallRestartsEstimate) {
+  CadenceEstimator estimator;
+  FeedLatched(&estimator, 24, 60, 60);
+  EXPECT_EQ(estimator.GetFrameRate(), 24u);
+
+  FeedLatched(&estimator, 24, 60, 10, 10 * kNsPerSec);
+  EXPECT_EQ(estimator.GetFrameRate(), 0u);
+}
+
+TEST(CadenceEstimatorTest, IgnoresNonIncreasingTimestamps) {
+  CadenceEstimator estimator;
+  FeedLatched(&estimator, 30, 60, 60);
+  estimator.AddTimestamp(0);
+  EXPECT_EQ(estimator.GetFrameRate(), 30u);
+
+  estimator.Reset();
+  EXPECT_EQ(estimator.GetFrameRate(), 0u);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -28,6 +28,7 @@
 */
 
 #include <utils/fence.h>
+#include <utils/fence_watcher.h>
 #include <core/sdm_types.h>
 #include <debug_handler.h>
 #include <assert.h>
@@ -118,19 +119,58 @@ shared_ptr<Fence> Fence::Merge(const std::vector<shared_ptr<Fence>> &fences, boo
 int Fence::Wait(const shared_ptr<Fence> &fence) {
   ASSERT_IF_NO_BUFFER_SYNC(g_buffer_sync_handler_);
 
+  if (fence && fence->signal_time_ns_.load()) {
+    return 0;
+  }
+
   return g_buffer_sync_handler_->SyncWait(Fence::Get(fence), 1000);
 }
 
 int Fence::Wait(const shared_ptr<Fence> &fence, int timeout) {
   ASSERT_IF_NO_BUFFER_SYNC(g_buffer_sync_handler_);
 
+  if (fence && fence->signal_time_ns_.load()) {
+    return 0;
+  }
+
   return g_buffer_sync_handler_->SyncWait(Fence::Get(fence), timeout);
 }
 
+int Fence::WaitAsync(const shared_ptr<Fence> &fence, int timeout,
+                     std::function<void(int status)> callback) {
+  if (!fence || fence->signal_time_ns_.load()) {
+    callback(0);
+    return 0;
+  }
+
+  // Watcher polls its own reference, fence object may be released by the client meanwhile.
+  int fd = Fence::Dup(fence);
+  if (fd < 0) {
+    return -errno;
+  }
+
+  return FenceWatcher::Get()->Register(fence, fd, timeout, std::move(callback));
+}
+
+std::future<int> Fence::WaitAsync(const shared_ptr<Fence> &fence, int timeout) {
+  auto promise = std::make_shared<std::promise<int>>();
+  std::future<int> future = promise->get_future();
+  int error = WaitAsync(fence, timeout, [promise](int status) { promise->set_value(status); });
+  if (error) {
+    promise->set_value(error);
+  }
+
+  return future;
+}
+
+int64_t Fence::GetSignalTime(const shared_ptr<Fence> &fence) {
+  return (fence ? fence->signal_time_ns_.load() : 0);
+}
+
 Fence::Status Fence::GetStatus(const shared_ptr<Fence> &fence) {
   ASSERT_IF_NO_BUFFER_SYNC(g_buffer_sync_handler_);
 
-  if (!fence) {
+  if (!fence || fence->signal_time_ns_.load()) {
     return Fence::Status::kSignaled;
   }
 
@@ -161,6 +201,7 @@ void Fence::Dump(std::ostringstream *os) {
     g_buffer_sync_handler_->GetSyncInfo(fence->fd_, os);
   }
   */
+  FenceWatcher::Get()->Dump(os);
   *os << "\n---------------------------------------\n";
 }
 
@@ -0,0 +1,165 @@
+/*
+* Copyright (c) 2024 The Linux Foundation. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of The Linux Foundation nor the names of its
+*       contributors may be used to endorse or promote products derived
+*       from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+* OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+* IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+#include <utils/fence.h>
+#include <errno.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>  // NOLINT
+#include <memory>
+#include <vector>
+
+using namespace sdm;
+
+namespace {
+
+// An eventfd polls like a sync file: it turns readable once written, which stands in for the
+// timeline signal without needing sw_sync.
+class TestFence {
+ public:
+  TestFence() {
+    int fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    signal_fd_ = dup(fd);
+    fence_ = Fence::Create(fd, "test_fence");
+  }
+
+  ~TestFence() { close(signal_fd_); }
+
+  void Signal() {
+    uint64_t value = 1;
+    ASSERT_EQ(write(signal_fd_, &value, sizeof(value)), ssize_t(sizeof(value)));
+  }
+
+  const shared_ptr<Fence> &Get() { return fence_; }
+
+ private:
+  int signal_fd_ = -1;
+  shared_ptr<Fence> fence_ = nullptr;
+};
+
+const auto kFutureTimeout = std::chrono::seconds(2);
+
+}  // namespace
+
+TEST(FenceWatcherTest, NullFenceCompletesInPlace) {
+  std::future<int> future = Fence::WaitAsync(nullptr, 100);
+  ASSERT_EQ(future.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+  EXPECT_EQ(future.get(), 0);
+}
+
+TEST(FenceWatcherTest, CompletesOnSignal) {
+  TestFence fence;
+  std::future<int> future = Fence::WaitAsync(fence.Get(), 1000);
+  EXPECT_EQ(future.wait_for(std::chrono::milliseconds(20)), std::future_status::timeout);
+  EXPECT_EQ(Fence::GetSignalTime(fence.Get()), 0);
+
+  fence.Signal();
+  ASSERT_EQ(future.wait_for(kFutureTimeout), std::future_status::ready);
+  EXPECT_EQ(future.get(), 0);
+  EXPECT_GT(Fence::GetSignalTime(fence.Get()), 0);
+
+  // Signaled fences complete in place from now on.
+  std::future<int> again = Fence::WaitAsync(fence.Get(), 1000);
+  ASSERT_EQ(again.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+  EXPECT_EQ(again.get(), 0);
+}
+
+TEST(FenceWatcherTest, TimesOut) {
+  TestFence fence;
+  auto start = std::chrono::steady_clock::now();
+  std::future<int> future = Fence::WaitAsync(fence.Get(), 30);
+  ASSERT_EQ(future.wait_for(kFutureTimeout), std::future_status::ready);
+  EXPECT_EQ(future.get(), -ETIME);
+  EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(30));
+  EXPECT_EQ(Fence::GetSignalTime(fence.Get()), 0);
+}
+
+TEST(FenceWatcherTest, ShorterDeadlineRegisteredLater) {
+  TestFence slow, fast;
+  std::future<int> slow_future = Fence::WaitAsync(slow.Get(), 5000);
+  std::future<int> fast_future = Fence::WaitAsync(fast.Get(), 20);
+  ASSERT_EQ(fast_future.wait_for(std::chrono::milliseconds(500)), std::future_status::ready);
+  EXPECT_EQ(fast_future.get(), -ETIME);
+
+  slow.Signal();
+  ASSERT_EQ(slow_future.wait_for(kFutureTimeout), std::future_status::ready);
+  EXPECT_EQ(slow_future.get(), 0);
+}
+
+TEST(FenceWatcherTest, OutlivesReleasedFence) {
+  auto fence = std::make_unique<TestFence>();
+
+  std::atomic<int> status = {1};
+  std::promise<void> done;
+  ASSERT_EQ(Fence::WaitAsync(fence->Get(), 1000, [&](int result) {
+    status = result;
+    done.set_value();
+  }), 0);
+
+  // Client drops its reference before the signal, the watcher keeps its own.
+  fence->Signal();
+  fence.reset();
+  ASSERT_EQ(done.get_future().wait_for(kFutureTimeout), std::future_status::ready);
+  EXPECT_EQ(status, 0);
+}
+
+TEST(FenceWatcherTest, ManyFences) {
+  const size_t kCount = 64;
+  std::vector<std::unique_ptr<TestFence>> fences;
+  std::vector<std::future<int>> futures;
+  for (size_t i = 0; i < kCount; i++) {
+    fences.push_back(std::make_unique<TestFence>());
+    futures.push_back(Fence::WaitAsync(fences.back()->Get(), 1000));
+  }
+
+  for (size_t i = 0; i < kCount; i += 2) {
+    fences[i]->Signal();
+  }
+  for (size_t i = 0; i < kCount; i += 2) {
+    ASSERT_EQ(futures[i].wait_for(kFutureTimeout), std::future_status::ready);
+    EXPECT_EQ(futures[i].get(), 0);
+  }
+  for (size_t i = 1; i < kCount; i += 2) {
+    EXPECT_EQ(futures[i].wait_for(std::chrono::seconds(0)), std::future_status::timeout);
+    fences[i]->Signal();
+  }
+  for (size_t i = 1; i < kCount; i += 2) {
+    ASSERT_EQ(futures[i].wait_for(kFutureTimeout), std::future_status::ready);
+    EXPECT_EQ(futures[i].get(), 0);
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
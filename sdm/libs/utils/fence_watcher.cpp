@@ -0,0 +1,230 @@
+/*
+* Copyright (c) 2024 The Linux Foundation. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of The Linux Foundation nor the names of its
+*       contributors may be used to endorse or promote products derived
+*       from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+* OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+* IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <utils/fence.h>
+#include <utils/fence_watcher.h>
+#include <utils/constants.h>
+#include <debug_handler.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#define __CLASS__ "FenceWatcher"
+
+namespace sdm {
+
+FenceWatcher *FenceWatcher::Get() {
+  // Intentionally never destroyed, the watcher thread lives as long as the process does.
+  static FenceWatcher *fence_watcher = new FenceWatcher();
+  return fence_watcher;
+}
+
+int64_t FenceWatcher::GetTimeNs() {
+  struct timespec ts = {};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + static_cast<int64_t>(ts.tv_nsec);
+}
+
+int FenceWatcher::Init() {
+  if (initialized_) {
+    return 0;
+  }
+
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd_ < 0) {
+    DLOGE("epoll_create1 failed. errno = %d, desc = %s", errno, strerror(errno));
+    return -errno;
+  }
+
+  // Wakes the watcher thread up whenever a registration changes the nearest deadline.
+  wakeup_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  struct epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.u64 = 0;
+  if (wakeup_fd_ < 0 || epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wakeup_fd_, &event) != 0) {
+    int error = -errno;
+    DLOGE("Failed to setup wakeup fd. errno = %d, desc = %s", errno, strerror(errno));
+    if (wakeup_fd_ >= 0) {
+      close(wakeup_fd_);
+      wakeup_fd_ = -1;
+    }
+    close(epoll_fd_);
+    epoll_fd_ = -1;
+    return error;
+  }
+
+  std::thread watcher_thread(&FenceWatcher::WatcherThread, this);
+  watcher_thread.detach();
+  initialized_ = true;
+
+  return 0;
+}
+
+int FenceWatcher::Register(const std::shared_ptr<Fence> &fence, int fd, int timeout_ms,
+                           Callback callback) {
+  int error = 0;
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    error = Init();
+    if (!error) {
+      uint64_t id = next_id_++;
+      struct epoll_event event = {};
+      event.events = EPOLLIN | EPOLLONESHOT;
+      event.data.u64 = id;
+      if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) == 0) {
+        Entry &entry = entries_[id];
+        entry.fd = fd;
+        entry.fence = fence;
+        entry.callback = std::move(callback);
+        entry.register_ns = GetTimeNs();
+        if (timeout_ms >= 0) {
+          entry.deadline_ns = entry.register_ns + static_cast<int64_t>(timeout_ms) * 1000000LL;
+          uint64_t wakeup = 1;
+          if (write(wakeup_fd_, &wakeup, sizeof(wakeup)) < 0) {
+            DLOGW("Failed to wake up watcher. errno = %d, desc = %s", errno, strerror(errno));
+          }
+        }
+        return 0;
+      }
+      error = -errno;
+      DLOGW("Failed to watch fd %d. errno = %d, desc = %s", fd, errno, strerror(errno));
+    }
+  }
+
+  close(fd);
+  return error;
+}
+
+void FenceWatcher::WatcherThread() {
+  std::vector<struct epoll_event> events(16);
+  std::vector<std::pair<Entry, int>> completed;
+
+  while (true) {
+    int timeout_ms = -1;
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      int64_t now_ns = GetTimeNs();
+      for (auto &it : entries_) {
+        if (!it.second.deadline_ns) {
+          continue;
+        }
+        int64_t remaining_ms = (std::max(it.second.deadline_ns - now_ns, int64_t(0)) + 999999) /
+                               1000000;
+        timeout_ms = (timeout_ms < 0) ? INT(remaining_ms) : std::min(timeout_ms, INT(remaining_ms));
+      }
+    }
+
+    int count = epoll_wait(epoll_fd_, events.data(), INT(events.size()), timeout_ms);
+    if (count < 0) {
+      if (errno != EINTR) {
+        DLOGE("epoll_wait failed. errno = %d, desc = %s", errno, strerror(errno));
+      }
+      continue;
+    }
+
+    int64_t now_ns = GetTimeNs();
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      for (int i = 0; i < count; i++) {
+        uint64_t id = events[i].data.u64;
+        if (!id) {
+          uint64_t wakeup = 0;
+          while (read(wakeup_fd_, &wakeup, sizeof(wakeup)) > 0) {}
+          continue;
+        }
+
+        auto it = entries_.find(id);
+        if (it == entries_.end()) {
+          continue;
+        }
+        int status = (events[i].events & EPOLLIN) ? 0 : -EINVAL;
+        completed.push_back(std::make_pair(std::move(it->second), status));
+        entries_.erase(it);
+      }
+
+      for (auto it = entries_.begin(); it != entries_.end();) {
+        if (it->second.deadline_ns && it->second.deadline_ns <= now_ns) {
+          completed.push_back(std::make_pair(std::move(it->second), -ETIME));
+          it = entries_.erase(it);
+        } else {
+          it++;
+        }
+      }
+
+      for (auto &done : completed) {
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, done.first.fd, NULL);
+        close(done.first.fd);
+        done.first.fd = -1;
+        if (done.second == 0) {
+          int64_t latency_ns = now_ns - done.first.register_ns;
+          signaled_count_++;
+          total_latency_ns_ += latency_ns;
+          max_latency_ns_ = std::max(max_latency_ns_, latency_ns);
+        } else if (done.second == -ETIME) {
+          timeout_count_++;
+        }
+      }
+    }
+
+    // Notify outside of the lock so that callbacks may register further fences.
+    for (auto &done : completed) {
+      Complete(&done.first, done.second, now_ns);
+    }
+    completed.clear();
+  }
+}
+
+void FenceWatcher::Complete(Entry *entry, int status, int64_t now_ns) {
+  if (status == 0) {
+    std::shared_ptr<Fence> fence = entry->fence.lock();
+    if (fence) {
+      fence->signal_time_ns_.store(now_ns);
+    }
+  }
+
+  if (entry->callback) {
+    entry->callback(status);
+  }
+}
+
+void FenceWatcher::Dump(std::ostringstream *os) {
+  std::lock_guard<std::mutex> lock(lock_);
+  int64_t avg_latency_ns = signaled_count_ ? total_latency_ns_ / static_cast<int64_t>(signaled_count_) : 0;
+  *os << "\nFence watcher: pending " << entries_.size() << " signaled " << signaled_count_
+      << " timed out " << timeout_count_ << " latency avg/max (us) " << avg_latency_ns / 1000 << "/"
+      << max_latency_ns_ / 1000;
+}
+
+}  // namespace sdm
@@ -350,5 +350,43 @@ DisplayError GetScaleFactor(const LayerRect &crop, const LayerRect &dst,
   return kErrorNone;
 }
 
-}  // namespace sdm
+static bool IsUnionExact(const LayerRect &rect1, const LayerRect &rect2) {
+  if (rect1.left == rect2.left && rect1.right == rect2.right) {
+    return (rect1.top <= rect2.bottom && rect2.top <= rect1.bottom);
+  }
+
+  if (rect1.top == rect2.top && rect1.bottom == rect2.bottom) {
+    return (rect1.left <= rect2.right && rect2.left <= rect1.right);
+  }
+
+  return (Contains(rect1, rect2) || Contains(rect2, rect1));
+}
+
+void CoalesceRects(const std::vector<LayerRect> &in_rects, std::vector<LayerRect> *out_rects) {
+  out_rects->clear();
+  for (auto &rect : in_rects) {
+    if (IsValid(rect)) {
+      out_rects->push_back(rect);
+    }
+  }
 
+  // Merging two rects can make the result mergeable with a rect visited earlier, repeat until the
+  // set is stable. Damage regions hold a handful of rects, the quadratic scan is cheap.
+  bool merged = true;
+  while (merged) {
+    merged = false;
+    for (size_t i = 0; i < out_rects->size(); i++) {
+      for (size_t j = i + 1; j < out_rects->size();) {
+        if (IsUnionExact(out_rects->at(i), out_rects->at(j))) {
+          out_rects->at(i) = Union(out_rects->at(i), out_rects->at(j));
+          out_rects->erase(out_rects->begin() + static_cast<std::ptrdiff_t>(j));
+          merged = true;
+        } else {
+          j++;
+        }
+      }
+    }
+  }
+}
+
+}  // namespace sdm
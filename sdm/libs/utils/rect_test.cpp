@@ -0,0 +1,140 @@
+/*
+* Copyright (c) 2024, The Linux Foundation. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of The Linux Foundation nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+* OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+* IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+#include <utils/rect.h>
+
+#include <random>
+#include <vector>
+
+using namespace sdm;
+
+namespace {
+
+// Rects on a coarse grid so that shared edges, touching and equal coordinates are frequent, with
+// a share of invalid and fractional rects.
+class RectGenerator {
+ public:
+  explicit RectGenerator(uint32_t seed) : engine_(seed) {}
+
+  LayerRect Next() {
+    std::uniform_int_distribution<int> coord(0, 16);
+    std::uniform_int_distribution<int> kind(0, 9);
+    float left = FLOAT(coord(engine_) * 64);
+    float top = FLOAT(coord(engine_) * 64);
+    float right = left + FLOAT((coord(engine_) + 1) * 64);
+    float bottom = top + FLOAT((coord(engine_) + 1) * 64);
+
+    switch (kind(engine_)) {
+      case 0:
+        std::swap(left, right);
+        break;
+      case 1:
+        bottom = top;
+        break;
+      case 2:
+        left += 0.5f;
+        bottom -= 0.25f;
+        break;
+      default:
+        break;
+    }
+
+    return LayerRect(left, top, right, bottom);
+  }
+
+  std::vector<LayerRect> Next(size_t count) {
+    std::vector<LayerRect> rects;
+    for (size_t i = 0; i < count; i++) {
+      rects.push_back(Next());
+    }
+    return rects;
+  }
+
+ private:
+  std::mt19937 engine_;
+};
+
+const uint32_t kIterations = 200;
+
+}  // namespace
+
+TEST(RectTest, CoalesceRectsPreservesCoverage) {
+  RectGenerator generator(7);
+  const int kGrid = 32;
+  for (uint32_t iter = 0; iter < kIterations; iter++) {
+    // Integer rects on a small grid so coverage can be compared cell by cell.
+    std::vector<LayerRect> rects;
+    for (auto &rect : generator.Next(iter % 12)) {
+      rects.push_back(LayerRect(rect.left / 64, rect.top / 64, rect.right / 64,
+                                rect.bottom / 64));
+      Normalize(1, 1, &rects.back());
+    }
+
+    std::vector<LayerRect> coalesced;
+    CoalesceRects(rects, &coalesced);
+
+    size_t valid_count = 0;
+    for (auto &rect : rects) {
+      valid_count += IsValid(rect) ? 1 : 0;
+    }
+    EXPECT_LE(coalesced.size(), valid_count);
+
+    for (int y = 0; y < kGrid; y++) {
+      for (int x = 0; x < kGrid; x++) {
+        LayerRect cell(FLOAT(x), FLOAT(y), FLOAT(x + 1), FLOAT(y + 1));
+        bool covered = false, covered_coalesced = false;
+        for (auto &rect : rects) {
+          covered |= Contains(rect, cell);
+        }
+        for (auto &rect : coalesced) {
+          covered_coalesced |= Contains(rect, cell);
+        }
+        ASSERT_EQ(covered, covered_coalesced) << "cell " << x << "x" << y << " iter " << iter;
+      }
+    }
+  }
+}
+
+TEST(RectTest, CoalesceRectsMergesAdjacent) {
+  std::vector<LayerRect> rects = {
+    LayerRect(0, 0, 100, 50), LayerRect(0, 50, 100, 80), LayerRect(100, 0, 200, 80),
+    LayerRect(10, 10, 20, 20), LayerRect(300, 300, 300, 400),
+  };
+
+  std::vector<LayerRect> coalesced;
+  CoalesceRects(rects, &coalesced);
+  ASSERT_EQ(1u, coalesced.size());
+  EXPECT_EQ(LayerRect(0, 0, 200, 80), coalesced[0]);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
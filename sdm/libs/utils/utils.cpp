@@ -206,4 +206,23 @@ const char *GetCompositionName(const LayerComposition &composition) {
   }
 }
 
+void HashedKey::Add(uint64_t value) {
+  words.push_back(value);
+  hash = HashCombine(hash, value);
+}
+
+void HashedKey::AddRect(const LayerRect &rect) {
+  uint32_t bits[4] = {};
+  std::memcpy(&bits[0], &rect.left, sizeof(uint32_t));
+  std::memcpy(&bits[1], &rect.top, sizeof(uint32_t));
+  std::memcpy(&bits[2], &rect.right, sizeof(uint32_t));
+  std::memcpy(&bits[3], &rect.bottom, sizeof(uint32_t));
+  Add((UINT64(bits[0]) << 32) | bits[1]);
+  Add((UINT64(bits[2]) << 32) | bits[3]);
+}
+
+bool HashedKey::operator==(const HashedKey &key) const {
+  return (hash == key.hash) && (words == key.words);
+}
+
 }  // namespace sdm
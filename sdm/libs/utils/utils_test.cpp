@@ -0,0 +1,83 @@
+/*
+* Copyright (c) 2024 The Linux Foundation. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of The Linux Foundation nor the names of its
+*       contributors may be used to endorse or promote products derived
+*       from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+* OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+* IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+#include <utils/utils.h>
+
+using namespace sdm;
+
+namespace {
+
+// Second word which makes a two word key starting with first hash to target.
+uint64_t CollidingWord(uint64_t first, uint64_t target) {
+  uint64_t seed = HashCombine(0, first);
+  return (target ^ seed) - 0x9e3779b97f4a7c15ULL - (seed << 6) - (seed >> 2);
+}
+
+}  // namespace
+
+TEST(HashedKeyTest, SameWordsAreEqual) {
+  HashedKey key1, key2;
+  for (uint64_t word : {1ULL, 2ULL, 3ULL}) {
+    key1.Add(word);
+    key2.Add(word);
+  }
+
+  EXPECT_EQ(key1.hash, key2.hash);
+  EXPECT_TRUE(key1 == key2);
+  key2.Add(4);
+  EXPECT_TRUE(key1 != key2);
+}
+
+TEST(HashedKeyTest, CollidingHashesAreNotEqual) {
+  HashedKey key1, key2;
+  key1.Add(1080);
+  key1.Add(2400);
+  key2.Add(720);
+  key2.Add(CollidingWord(720, key1.hash));
+
+  ASSERT_EQ(key1.hash, key2.hash);
+  EXPECT_TRUE(key1 != key2);
+}
+
+TEST(HashedKeyTest, RectsCompareOnAllEdges) {
+  HashedKey key1, key2, key3;
+  key1.AddRect(LayerRect(0, 0, 1080, 2400));
+  key2.AddRect(LayerRect(0, 0, 1080, 2400));
+  key3.AddRect(LayerRect(0, 0, 1080, 2399.5f));
+
+  EXPECT_TRUE(key1 == key2);
+  EXPECT_TRUE(key1 != key3);
+  EXPECT_EQ(key1.words.size(), 2u);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -27,6 +27,7 @@
 * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <string.h>
 #include <string>
 #include <vector>
 
@@ -1006,6 +1007,83 @@ int ClientImpl::AllowIdleFallback() {
   return error;
 }
 
+int ClientImpl::PerformBatch(std::vector<BatchOp> *ops) {
+  if (!ops) {
+    return -EINVAL;
+  }
+
+  if (!display_config_) {
+    return -ENODEV;
+  }
+
+  std::vector<uint8_t> batch;
+  for (auto &op : *ops) {
+    BatchOpHeader header = {op.op_code, static_cast<uint32_t>(op.input.size())};
+    const uint8_t *data = reinterpret_cast<const uint8_t*>(&header);
+    batch.insert(batch.end(), data, data + sizeof(BatchOpHeader));
+    batch.insert(batch.end(), op.input.begin(), op.input.end());
+  }
+
+  ByteStream input_params;
+  input_params.setToExternal(batch.data(), batch.size());
+  ByteStream output_params;
+  int error = 0;
+  auto hidl_cb = [&error, &output_params] (int32_t err, ByteStream params, HandleStream handles) {
+    error = err;
+    output_params = params;
+  };
+
+  auto ret = display_config_->perform(client_handle_, kPerformBatch, input_params, {}, hidl_cb);
+  if (!ret.isOk()) {
+    return -EPIPE;
+  }
+
+  // A service that predates kPerformBatch rejects it as an unknown opcode with -EINVAL, and
+  // has run nothing, so it is safe to replay the ops one transaction at a time. Any other
+  // error comes from a service that understood the batch and is returned as is.
+  if (error == -EINVAL) {
+    return PerformSerial(ops);
+  }
+
+  if (error) {
+    return error;
+  }
+
+  const uint8_t *data = output_params.data();
+  size_t size = output_params.size();
+  size_t offset = 0;
+  for (auto &op : *ops) {
+    BatchResultHeader result = {};
+    if (size - offset < sizeof(BatchResultHeader)) {
+      return -EINVAL;
+    }
+    memcpy(&result, data + offset, sizeof(BatchResultHeader));
+    offset += sizeof(BatchResultHeader);
+    if (size - offset < result.size) {
+      return -EINVAL;
+    }
+    op.error = result.error;
+    op.output.assign(data + offset, data + offset + result.size);
+    offset += result.size;
+  }
+
+  return 0;
+}
+
+int ClientImpl::PerformSerial(std::vector<BatchOp> *ops) {
+  for (auto &op : *ops) {
+    ByteStream input_params;
+    input_params.setToExternal(op.input.data(), op.input.size());
+    auto hidl_cb = [&op] (int32_t err, ByteStream params, HandleStream handles) {
+      op.error = err;
+      op.output.assign(params.data(), params.data() + params.size());
+    };
+    display_config_->perform(client_handle_, op.op_code, input_params, {}, hidl_cb);
+  }
+
+  return 0;
+}
+
 void ClientCallback::ParseNotifyCWBBufferDone(const ByteStream &input_params,
                                               const HandleStream &input_handles) {
   const int *error;
@@ -129,7 +129,18 @@ class ClientImpl : public ClientInterface {
   virtual int AllowIdleFallback();
   virtual int DummyDisplayConfigAPI();
 
+  struct BatchOp {
+    uint32_t op_code = 0;
+    std::vector<uint8_t> input;
+    int32_t error = 0;
+    std::vector<uint8_t> output;
+  };
+  // Issues all ops in a single transaction. Per-op results are written back into ops.
+  int PerformBatch(std::vector<BatchOp> *ops);
+
  private:
+  int PerformSerial(std::vector<BatchOp> *ops);
+
   android::sp<IDisplayConfig> display_config_ = nullptr;
   uint64_t client_handle_ = 0;
 };
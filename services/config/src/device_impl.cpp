@@ -63,7 +63,9 @@
 * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <string.h>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "device_impl.h"
@@ -923,6 +925,76 @@ Return<void> DeviceImpl::perform(uint64_t client_handle, uint32_t op_code,
     _hidl_cb(error, {}, {});
      return Void();
   }
+
+  if (op_code == kPerformBatch) {
+    ParseBatch(client, client_handle, input_params, _hidl_cb);
+    return Void();
+  }
+
+  DispatchOpcode(client, client_handle, op_code, input_params, input_handles, _hidl_cb);
+  return Void();
+}
+
+void DeviceImpl::ParseBatch(std::shared_ptr<DeviceClientContext> client, uint64_t client_handle,
+                            const ByteStream &input_params, perform_cb _hidl_cb) {
+  const uint8_t *data = input_params.data();
+  size_t size = input_params.size();
+  size_t offset = 0;
+
+  // Validate the whole stream up front so that a malformed batch runs none of its ops.
+  std::vector<std::pair<BatchOpHeader, size_t>> ops;
+  while (offset < size) {
+    BatchOpHeader op = {};
+    if (size - offset < sizeof(BatchOpHeader)) {
+      _hidl_cb(-EBADMSG, {}, {});
+      return;
+    }
+    memcpy(&op, data + offset, sizeof(BatchOpHeader));
+    offset += sizeof(BatchOpHeader);
+    if (size - offset < op.size) {
+      _hidl_cb(-EBADMSG, {}, {});
+      return;
+    }
+
+    // Ops that carry handles, tear down the client or nest batches are not batchable.
+    if (op.op_code == kPerformBatch || op.op_code == kDestroy ||
+        op.op_code == kSetCwbOutputBuffer) {
+      _hidl_cb(-EBADMSG, {}, {});
+      return;
+    }
+    ops.push_back(std::make_pair(op, offset));
+    offset += op.size;
+  }
+
+  std::vector<uint8_t> results;
+  for (auto &op : ops) {
+    BatchResultHeader result = {};
+    ByteStream op_params;
+    ByteStream output_params;
+    op_params.setToExternal(const_cast<uint8_t *>(data + op.second), op.first.size);
+    auto op_cb = [&result, &output_params] (int32_t err, const ByteStream &params,
+                                            const HandleStream &handles) {
+      result.error = err;
+      output_params = params;
+    };
+    DispatchOpcode(client, client_handle, op.first.op_code, op_params, {}, op_cb);
+
+    result.size = static_cast<uint32_t>(output_params.size());
+    const uint8_t *header = reinterpret_cast<const uint8_t *>(&result);
+    results.insert(results.end(), header, header + sizeof(BatchResultHeader));
+    results.insert(results.end(), output_params.data(),
+                   output_params.data() + output_params.size());
+  }
+
+  ByteStream output_params;
+  output_params.setToExternal(results.data(), results.size());
+  _hidl_cb(0, output_params, {});
+}
+
+void DeviceImpl::DispatchOpcode(std::shared_ptr<DeviceClientContext> client,
+                                uint64_t client_handle, uint32_t op_code,
+                                const ByteStream &input_params, const HandleStream &input_handles,
+                                perform_cb _hidl_cb) {
   switch (op_code) {
     case kIsDisplayConnected:
       client->ParseIsDisplayConnected(input_params, _hidl_cb);
@@ -1084,7 +1156,6 @@ Return<void> DeviceImpl::perform(uint64_t client_handle, uint32_t op_code,
       _hidl_cb(-EINVAL, {}, {});
       break;
   }
-  return Void();
 }
 
 }  // namespace DisplayConfig
@@ -176,6 +176,11 @@ class DeviceImpl : public IDisplayConfig, public android::hardware::hidl_death_r
   void serviceDied(uint64_t client_handle,
                    const android::wp<::android::hidl::base::V1_0::IBase>& callback);
   void ParseDestroy(uint64_t client_handle, perform_cb _hidl_cb);
+  void ParseBatch(std::shared_ptr<DeviceClientContext> client, uint64_t client_handle,
+                  const ByteStream &input_params, perform_cb _hidl_cb);
+  void DispatchOpcode(std::shared_ptr<DeviceClientContext> client, uint64_t client_handle,
+                      uint32_t op_code, const ByteStream &input_params,
+                      const HandleStream &input_handles, perform_cb _hidl_cb);
 
   ClientContext *intf_ = nullptr;
   std::map<uint64_t, std::shared_ptr<DeviceClientContext>> display_config_map_;
@@ -30,6 +30,8 @@
 #ifndef __OPCODE_TYPES_H__
 #define __OPCODE_TYPES_H__
 
+#include <stdint.h>
+
 namespace DisplayConfig {
 
 enum OpCode {
@@ -84,10 +86,24 @@ enum OpCode {
   kGetDisplayType = 48,
   kAllowIdleFallback = 49,
   kDummyOpcode = 50,
+  kPerformBatch = 51,
 
   kDestroy = 0xFFFF, // Destroy sequence execution
 };
 
+// kPerformBatch streams are a packed sequence of header + payload records, one per opcode.
+// Replies carry one record per request entry, in request order. The service validates the whole
+// stream before running any op and rejects a malformed or non-batchable stream with -EBADMSG.
+struct BatchOpHeader {
+  uint32_t op_code = 0;
+  uint32_t size = 0;
+};
+
+struct BatchResultHeader {
+  int32_t error = 0;
+  uint32_t size = 0;
+};
+
 }  // namespace DisplayConfig
 
 #endif  // __OPCODE_TYPES_H__